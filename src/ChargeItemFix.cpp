@@ -16,6 +16,7 @@
 #include "config/configutilities.hpp"
 #include "formatters/TESSoulGem.hpp"
 #include "messages.hpp"
+#include "utilities/Metrics.hpp"
 #include "utilities/misc.hpp"
 #include "utilities/native.hpp"
 
@@ -49,10 +50,18 @@ namespace {
     {
         const auto dataList = dataListPtr ? *dataListPtr : nullptr;
 
+        LOG_CHANNEL_DEBUG_FMT(
+            LogChannel::Charge,
+            "[CHARGE] Consuming reusable soul gem {}",
+            *soulGemToConsume);
+
         // This soul gem uses extra data to store the contained soul size,
         // so we set that instead.
         if (dataList && dataList->GetSoulLevel() != RE::SOUL_LEVEL::kNone) {
             native::BSExtraDataList::SetSoul(dataList, RE::SOUL_LEVEL::kNone);
+            Metrics::getInstance().recordSoulGemConsumption(
+                SoulGemConsumer::Charge,
+                SoulGemConsumption::ExtraDataCleared);
             return;
         }
 
@@ -72,14 +81,21 @@ namespace {
                 // something has gone very wrong (in ESP/config files).
                 RE::DebugNotification(
                     getMessage(MiscMessage::CannotFindSoulGemBaseForm));
-                LOG_ERROR_FMT(
+                LOG_CHANNEL_ERROR_FMT(
+                    LogChannel::Charge,
                     "[CHARGE] Cannot find base form for soul gem {} and soul "
                     "gem has no extra data. Soul gem will not be consumed.",
                     *soulGemToConsume);
+                Metrics::getInstance().recordSoulGemConsumption(
+                    SoulGemConsumer::Charge,
+                    SoulGemConsumption::BaseFormNotFound);
             } else {
                 native::BSExtraDataList::SetSoul(
                     dataList,
                     RE::SOUL_LEVEL::kNone);
+                Metrics::getInstance().recordSoulGemConsumption(
+                    SoulGemConsumer::Charge,
+                    SoulGemConsumption::ExtraDataCleared);
             }
             return;
         }
@@ -120,6 +136,10 @@ namespace {
             RE::ITEM_REMOVE_REASON::kRemove,
             dataList,
             nullptr);
+
+        Metrics::getInstance().recordSoulGemConsumption(
+            SoulGemConsumer::Charge,
+            SoulGemConsumption::ReplacedWithBaseForm);
     }
 
     struct Patch_ : Xbyak::CodeGenerator {
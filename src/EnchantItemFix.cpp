@@ -15,6 +15,7 @@
 #include "trampoline.hpp"
 #include "config/configutilities.hpp"
 #include "formatters/TESSoulGem.hpp"
+#include "utilities/Metrics.hpp"
 #include "utilities/misc.hpp"
 #include "utilities/native.hpp"
 
@@ -48,8 +49,16 @@ namespace {
     {
         const auto dataList = dataListPtr ? *dataListPtr : nullptr;
 
+        LOG_CHANNEL_DEBUG_FMT(
+            LogChannel::Enchant,
+            "[ENCHANT] Consuming reusable soul gem {}",
+            *soulGemToConsume);
+
         if (dataList && dataList->GetSoulLevel() != RE::SOUL_LEVEL::kNone) {
             native::BSExtraDataList::SetSoul(dataList, RE::SOUL_LEVEL::kNone);
+            Metrics::getInstance().recordSoulGemConsumption(
+                SoulGemConsumer::Enchant,
+                SoulGemConsumption::ExtraDataCleared);
             return;
         }
 
@@ -69,14 +78,21 @@ namespace {
                 // something has gone very wrong (in ESP/config files).
                 RE::DebugNotification(
                     getMessage(MiscMessage::CannotFindSoulGemBaseForm));
-                LOG_ERROR_FMT(
+                LOG_CHANNEL_ERROR_FMT(
+                    LogChannel::Enchant,
                     "[ENCHANT] Cannot find base form for soul gem {} and soul "
                     "gem has no extra data. Soul gem will not be consumed.",
                     *soulGemToConsume);
+                Metrics::getInstance().recordSoulGemConsumption(
+                    SoulGemConsumer::Enchant,
+                    SoulGemConsumption::BaseFormNotFound);
             } else {
                 native::BSExtraDataList::SetSoul(
                     dataList,
                     RE::SOUL_LEVEL::kNone);
+                Metrics::getInstance().recordSoulGemConsumption(
+                    SoulGemConsumer::Enchant,
+                    SoulGemConsumption::ExtraDataCleared);
             }
             return;
         }
@@ -95,6 +111,10 @@ namespace {
             RE::ITEM_REMOVE_REASON::kRemove,
             dataList,
             nullptr);
+
+        Metrics::getInstance().recordSoulGemConsumption(
+            SoulGemConsumer::Enchant,
+            SoulGemConsumption::ReplacedWithBaseForm);
     }
 
     struct Patch_ : Xbyak::CodeGenerator {
@@ -8,7 +8,7 @@
 
 #include <RE/S/SoulLevels.h>
 
-#include "../utilities/stringutils.hpp"
+#include "utilities/stringutils.hpp"
 
 enum class SoulSize {
     None,
@@ -85,6 +85,8 @@ enum class SoulGemCapacity {
         return SoulSize::Grand;
     case SoulGemCapacity::Black:
         return SoulSize::Black;
+    default:
+        break;
     }
 
     throw std::runtime_error(fmt::format(
@@ -108,6 +110,8 @@ enum class SoulGemCapacity {
     case SoulSize::Grand:
     case SoulSize::Black:
         return SoulLevelValue::Grand;
+    default:
+        break;
     }
 
     throw std::runtime_error(fmt::format(
@@ -132,6 +136,8 @@ enum class SoulGemCapacity {
     case SoulSize::Grand:
     case SoulSize::Black:
         return RE::SOUL_LEVEL::kGrand;
+    default:
+        break;
     }
 
     throw std::runtime_error(fmt::format(
@@ -155,6 +161,8 @@ enum class SoulGemCapacity {
     case SoulGemCapacity::Dual:
     case SoulGemCapacity::Black:
         return RE::SOUL_LEVEL::kGrand;
+    default:
+        break;
     }
 
     throw std::runtime_error(fmt::format(
@@ -181,6 +189,8 @@ enum class SoulGemCapacity {
         return SoulGemCapacity::Grand;
     case SoulSize::Black:
         return SoulGemCapacity::Black;
+    default:
+        break;
     }
 
     throw std::runtime_error(fmt::format(
@@ -251,6 +261,8 @@ enum class SoulGemCapacity {
         return "grand";
     case SoulSize::Black:
         return "black";
+    default:
+        break;
     }
 
     throw std::runtime_error(fmt::format(
@@ -275,6 +287,8 @@ enum class SoulGemCapacity {
         return "dual";
     case SoulGemCapacity::Black:
         return "black";
+    default:
+        break;
     }
 
     // Avoid using the formatter since the formatter also calls this function,
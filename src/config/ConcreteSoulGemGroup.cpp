@@ -6,46 +6,13 @@
 
 #include "../global.hpp"
 #include "FormError.hpp"
+#include "SoulTierTable.hpp"
 #include "SpecificationError.hpp"
 #include "../formatters/TESSoulGem.hpp"
 #include "../utilities/misc.hpp"
 #include "../utilities/native.hpp"
 
 namespace {
-    SoulSize toContainedSoulSize_(
-        const SoulGemCapacity capacity,
-        const std::size_t index)
-    {
-        if (capacity == SoulGemCapacity::Black) {
-            switch (index) {
-            case 0:
-                return SoulSize::None;
-            case 1:
-                return SoulSize::Black;
-            }
-        } else {
-            switch (index) {
-            case 0:
-                return SoulSize::None;
-            case 1:
-                return SoulSize::Petty;
-            case 2:
-                return SoulSize::Lesser;
-            case 3:
-                return SoulSize::Common;
-            case 4:
-                return SoulSize::Greater;
-            case 5:
-                return SoulSize::Grand;
-            }
-        }
-
-        throw std::runtime_error(fmt::format(
-            FMT_STRING("Invalid member index {} for capacity {}"),
-            index,
-            capacity));
-    }
-
     template <typename T>
     void checkFormIsNotNull_(RE::TESForm* const form, const T& formLocator)
     {
@@ -158,7 +125,10 @@ void ConcreteSoulGemGroup::initializeFromPrimaryBasis_(
     const SoulGemGroup& sourceGroup,
     RE::TESDataHandler* const dataHandler)
 {
+    id_ = sourceGroup.id();
     capacity_ = sourceGroup.capacity();
+    isReusable_ = sourceGroup.isReusable();
+    priority_ = sourceGroup.priority();
 
     for (std::size_t i = 0; i < sourceGroup.members().size(); ++i) {
         const auto& formLocator = sourceGroup.members().at(i);
@@ -185,7 +155,7 @@ void ConcreteSoulGemGroup::initializeFromPrimaryBasis_(
             formLocator);
 
         forms_.emplace(
-            toContainedSoulSize_(sourceGroup.capacity(), i),
+            SoulTierTable::toContainedSoulSize(sourceGroup.capacity(), i),
             soulGemForm);
     }
 }
@@ -28,6 +28,8 @@ private:
 
     IdType id_;
     SoulGemCapacity capacity_;
+    bool isReusable_;
+    LoadPriority priority_;
 
     FormMap forms_;
 
@@ -70,6 +72,12 @@ public:
     {
         return capacity_;
     }
+    [[nodiscard]] bool isReusable() const noexcept { return isReusable_; }
+    /**
+     * @brief Returns the resolved load priority of the source group (never
+     * LoadPriority::Auto).
+     */
+    [[nodiscard]] LoadPriority priority() const noexcept { return priority_; }
 
     RE::TESSoulGem* at(const SoulSize containedSoulSize) const
     {
@@ -104,6 +104,8 @@ inline constexpr std::string_view
         return toString(static_cast<SoulShrinkingTechnique>(value));
     case EnumConfigKey::SoulTrapLevelingType:
         return toString(static_cast<SoulShrinkingTechnique>(value));
+    default:
+        break;
     }
 
     return ""sv;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <bitset>
+#include <unordered_map>
+#include <utility>
+
+#include "ConfigKey/BoolConfigKey.hpp"
+#include "ConfigKey/EnumConfigKey.hpp"
+#include "ConfigKey/IntConfigKey.hpp"
+
+class YASTMConfig;
+
+/**
+ * @brief Represents a snapshot of the configuration at a certain point in
+ * time.
+ */
+class ConfigSnapshot {
+public:
+    using BoolValues =
+        std::bitset<static_cast<std::size_t>(BoolConfigKey::Count)>;
+    using EnumValues =
+        std::unordered_map<EnumConfigKey, EnumConfigUnderlyingType>;
+    using IntValues = std::unordered_map<IntConfigKey, int>;
+
+private:
+    BoolValues configBools_;
+    EnumValues configEnums_;
+    IntValues configInts_;
+
+    void printValues_() const;
+    void printValues_(
+        const decltype(configBools_)& overrideBools,
+        const decltype(configEnums_)& overrideEnums) const;
+    void initialize_(const YASTMConfig& config);
+    void normalize_();
+
+public:
+    explicit ConfigSnapshot(const YASTMConfig& config);
+    explicit ConfigSnapshot(const YASTMConfig& config, int soulTrapLevel);
+    /**
+     * @brief Constructs a snapshot with the given values as-is. Used where the
+     * configuration global variables aren't available.
+     */
+    explicit ConfigSnapshot(
+        BoolValues bools,
+        EnumValues enums,
+        IntValues ints) noexcept
+        : configBools_(std::move(bools))
+        , configEnums_(std::move(enums))
+        , configInts_(std::move(ints))
+    {}
+
+    template <EnumConfigKey K>
+    auto get() const;
+
+    bool operator[](BoolConfigKey key) const;
+    int operator[](IntConfigKey key) const;
+};
+
+template <EnumConfigKey K>
+inline auto ConfigSnapshot::get() const
+{
+    return static_cast<EnumConfigKeyTypeMap<K>::type>(configEnums_.at(K));
+}
+
+inline bool ConfigSnapshot::operator[](const BoolConfigKey key) const
+{
+    return configBools_[static_cast<std::size_t>(key)];
+}
+
+inline int ConfigSnapshot::operator[](const IntConfigKey key) const
+{
+    return configInts_.at(key);
+}
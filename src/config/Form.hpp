@@ -26,7 +26,9 @@ public:
     explicit Form() noexcept {}
     virtual ~Form() {}
 
-    void setFromTomlArray(const toml::array& arr);
+    void setFromTomlArray(
+        const toml::array& arr,
+        PluginNameTable& pluginNames);
     void setFromTomlString(std::string str);
     void loadForm(RE::TESDataHandler* dataHandler);
     void clear() noexcept
@@ -43,9 +45,11 @@ public:
 };
 
 template <typename T>
-inline void Form<T>::setFromTomlArray(const toml::array& arr)
+inline void Form<T>::setFromTomlArray(
+    const toml::array& arr,
+    PluginNameTable& pluginNames)
 {
-    formLocator_.emplace(FormId(arr));
+    formLocator_.emplace(FormId(arr, pluginNames));
 }
 
 template <typename T>
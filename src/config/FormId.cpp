@@ -1,25 +1,50 @@
 #include "FormId.hpp"
 
+#include <boost/container_hash/hash.hpp>
+
 #include "ParseError.hpp"
 
-FormId::FormId(const toml::array& arr)
-{
-    auto formIdValue = arr[0].as_integer();
-    auto pluginNameValue = arr[1].as_string();
+namespace {
+    RE::FormID parseId_(const toml::array& arr)
+    {
+        const auto formIdValue = arr[0].as_integer();
+
+        if (formIdValue == nullptr) {
+            throw ParseError("Form ID is missing or invalid");
+        }
 
-    if (formIdValue == nullptr) {
-        throw ParseError("Form ID is missing or invalid");
+        return static_cast<RE::FormID>(formIdValue->get());
     }
 
-    if (pluginNameValue == nullptr) {
-        throw ParseError("Plugin name is missing or invalid");
+    const std::string& parsePluginName_(const toml::array& arr)
+    {
+        const auto pluginNameValue = arr[1].as_string();
+
+        if (pluginNameValue == nullptr) {
+            throw ParseError("Plugin name is missing or invalid");
+        }
+
+        return pluginNameValue->get();
     }
+} // namespace
 
-    id_ = static_cast<RE::FormID>(formIdValue->get());
-    pluginName_ = pluginNameValue->get();
+FormId::FormId(const RE::FormID id, const PluginNameTable::Entry& plugin)
+    : id_(id)
+    , pluginIndex_(plugin.index)
+    , pluginName_(&plugin.name)
+    , hashCode_(0)
+{
+    boost::hash_combine(hashCode_, id_);
+    boost::hash_combine(hashCode_, pluginIndex_);
 }
 
-FormId::FormId(const RE::FormID id, std::string_view pluginName)
-    : id_(id)
-    , pluginName_(pluginName)
+FormId::FormId(const toml::array& arr, PluginNameTable& pluginNames)
+    : FormId(parseId_(arr), pluginNames.intern(parsePluginName_(arr)))
+{}
+
+FormId::FormId(
+    const RE::FormID id,
+    const std::string_view pluginName,
+    PluginNameTable& pluginNames)
+    : FormId(id, pluginNames.intern(pluginName))
 {}
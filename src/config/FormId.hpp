@@ -1,63 +1,42 @@
 #pragma once
 
-#include <exception>
-#include <iterator>
-#include <optional>
 #include <string>
-#include <type_traits>
-#include <unordered_set>
+#include <string_view>
 
 #include <cstdint>
 
-#include <boost/container_hash/hash.hpp>
 #include <fmt/format.h>
 #include <toml++/toml.h>
 
 #include <RE/B/BSCoreTypes.h>
 
-#include "../utilities/stringutils.hpp"
-
+#include "PluginNameTable.hpp"
+
+/**
+ * @brief Identifies a form by its local form ID and the plugin that defines it.
+ *
+ * The plugin name is interned into a PluginNameTable when the form ID is
+ * created, so the form ID itself is an immutable (plugin index, local form ID)
+ * pair with a precomputed hash. This makes copying, hashing and comparing form
+ * IDs cheap and safe to do from multiple threads.
+ *
+ * Form IDs should only be compared with form IDs interned into the same
+ * table, and must not outlive it.
+ */
 class FormId {
     RE::FormID id_;
-    std::string pluginName_;
-
-    mutable std::optional<std::string> cachedPluginNameLower_;
-    mutable std::optional<std::size_t> cachedHashCode_;
-
-    /**
-     * @brief Lowercase-only version of the plugin name. For comparison and
-     * hashing.
-     **/
-    const std::string& pluginNameLower_() const
-    {
-        if (cachedPluginNameLower_.has_value()) {
-            return *cachedPluginNameLower_;
-        }
-
-        cachedPluginNameLower_ = getLowerString(pluginName_);
-
-        return *cachedPluginNameLower_;
-    }
-
-    std::size_t calculateHashCode_() const
-    {
-        std::size_t seed = 0;
-
-        boost::hash_combine(seed, id_);
-        boost::hash_combine(seed, pluginNameLower_());
+    PluginNameTable::Index pluginIndex_;
+    const std::string* pluginName_;
+    std::size_t hashCode_;
 
-        return seed;
-    }
-
-    void invalidateCache_() const
-    {
-        cachedPluginNameLower_.reset();
-        cachedHashCode_.reset();
-    }
+    explicit FormId(RE::FormID id, const PluginNameTable::Entry& plugin);
 
 public:
-    explicit FormId(const toml::array& arr);
-    explicit FormId(RE::FormID id, std::string_view pluginName);
+    explicit FormId(const toml::array& arr, PluginNameTable& pluginNames);
+    explicit FormId(
+        RE::FormID id,
+        std::string_view pluginName,
+        PluginNameTable& pluginNames);
 
     FormId(const FormId&) = default;
     FormId(FormId&&) = default;
@@ -65,24 +44,18 @@ public:
     FormId& operator=(FormId&&) = default;
 
     RE::FormID id() const noexcept { return id_; }
-    const std::string& pluginName() const noexcept { return pluginName_; }
-
-    friend bool operator==(const FormId& lhs, const FormId& rhs) noexcept
+    PluginNameTable::Index pluginIndex() const noexcept
     {
-        return lhs.id_ == rhs.id_ &&
-               lhs.pluginNameLower_() == rhs.pluginNameLower_();
+        return pluginIndex_;
     }
+    const std::string& pluginName() const noexcept { return *pluginName_; }
 
-    std::size_t hash() const
+    friend bool operator==(const FormId& lhs, const FormId& rhs) noexcept
     {
-        if (cachedHashCode_.has_value()) {
-            return *cachedHashCode_;
-        }
-
-        cachedHashCode_ = calculateHashCode_();
-
-        return *cachedHashCode_;
+        return lhs.id_ == rhs.id_ && lhs.pluginIndex_ == rhs.pluginIndex_;
     }
+
+    std::size_t hash() const noexcept { return hashCode_; }
 };
 
 // Inject hash specialization into std namespace.
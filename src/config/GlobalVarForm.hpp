@@ -30,14 +30,15 @@ public:
 template <typename KeyType>
 inline float GlobalVarForm<KeyType>::value() const
 {
-    using namespace std::literals;
-
     if (isFormLoaded()) {
         return form_->value;
     }
 
-    LOG_INFO_FMT(
-        "Form for {} not loaded. Returning default value."sv,
+    // This is called on every soul trap (through the configuration snapshot),
+    // so only log this once per rate limit window for each key.
+    LOG_CHANNEL_INFO_LIMITED_FMT(
+        LogChannel::Config,
+        "Form for {} not loaded. Returning default value.",
         toString(key()));
     return defaultValue_;
 }
@@ -0,0 +1,34 @@
+#include "PluginNameTable.hpp"
+
+#include <mutex>
+#include <utility>
+
+#include "../utilities/stringutils.hpp"
+
+const PluginNameTable::Entry&
+    PluginNameTable::intern(const std::string_view pluginName)
+{
+    auto pluginNameLower = getLowerString(pluginName);
+
+    {
+        std::shared_lock lock(mutex_);
+
+        if (const auto it = entries_.find(pluginNameLower);
+            it != entries_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+
+    // Another thread may have interned the same name between the two locks,
+    // in which case this returns the existing entry.
+    const auto index = static_cast<Index>(entries_.size());
+    const auto it = entries_
+                        .try_emplace(
+                            std::move(pluginNameLower),
+                            Entry{index, std::string(pluginName)})
+                        .first;
+
+    return it->second;
+}
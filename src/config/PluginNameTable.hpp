@@ -0,0 +1,65 @@
+#pragma once
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <cstdint>
+
+/**
+ * @brief Interns plugin names so that form IDs can refer to their plugin by
+ * index instead of storing their own copy of the name.
+ *
+ * Plugin names are matched case-insensitively. The first spelling interned is
+ * kept for display purposes.
+ *
+ * Interning is thread-safe. Entries are never moved or removed until clear()
+ * is called, so references returned by intern() stay valid until then.
+ */
+class PluginNameTable {
+public:
+    using Index = std::uint32_t;
+
+    struct Entry {
+        Index index;
+        std::string name;
+    };
+
+private:
+    /**
+     * @brief Maps the lowercase plugin name to its entry.
+     */
+    std::unordered_map<std::string, Entry> entries_;
+    mutable std::shared_mutex mutex_;
+
+public:
+    explicit PluginNameTable() = default;
+    PluginNameTable(const PluginNameTable&) = delete;
+    PluginNameTable(PluginNameTable&&) = delete;
+    PluginNameTable& operator=(const PluginNameTable&) = delete;
+    PluginNameTable& operator=(PluginNameTable&&) = delete;
+
+    /**
+     * @brief Returns the entry for the given plugin name, adding it to the
+     * table if it doesn't exist yet.
+     */
+    const Entry& intern(std::string_view pluginName);
+
+    std::size_t size() const
+    {
+        std::shared_lock lock(mutex_);
+        return entries_.size();
+    }
+
+    /**
+     * @brief Removes all entries. Invalidates every FormId created with this
+     * table.
+     */
+    void clear()
+    {
+        std::unique_lock lock(mutex_);
+        entries_.clear();
+    }
+};
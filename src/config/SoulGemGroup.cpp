@@ -12,6 +12,7 @@
 #include "../utilities/algorithms.hpp"
 #include "FormId.hpp"
 #include "ParseError.hpp"
+#include "SoulTierTable.hpp"
 
 using namespace std::literals;
 
@@ -45,19 +46,6 @@ namespace {
             CAPACITY_KEY_));
     }
 
-    std::size_t
-        getExpectedMemberCountForCapacity_(const SoulGemCapacity capacity)
-    {
-        switch (capacity) {
-        case SoulGemCapacity::Dual:
-            return 6;
-        case SoulGemCapacity::Black:
-            return 2;
-        }
-
-        return capacity + 2;
-    }
-
     std::string parseId_(const toml::table& table)
     {
         const auto value = table[ID_KEY_].as_string();
@@ -111,8 +99,10 @@ namespace {
         return priority;
     }
 
-    SoulGemGroup::MemberList
-        parseMembers_(const toml::table& table, const SoulGemCapacity capacity)
+    SoulGemGroup::MemberList parseMembers_(
+        const toml::table& table,
+        const SoulGemCapacity capacity,
+        PluginNameTable& pluginNames)
     {
         const auto value = table[MEMBERS_KEY_].as_array();
 
@@ -129,7 +119,10 @@ namespace {
             try {
                 elem.visit([&](auto&& el) {
                     if constexpr (toml::is_array<decltype(el)>) {
-                        members.emplace_back(std::in_place_type<FormId>, el);
+                        members.emplace_back(
+                            std::in_place_type<FormId>,
+                            el,
+                            pluginNames);
                     } else if constexpr (toml::is_string<decltype(el)>) {
                         members.emplace_back(
                             std::in_place_type<std::string>,
@@ -157,7 +150,7 @@ namespace {
         }
 
         if (const auto expectedMemberCount =
-                getExpectedMemberCountForCapacity_(capacity);
+                SoulTierTable::memberCount(capacity);
             expectedMemberCount != members.size()) {
             throw ParseError(fmt::format(
                 FMT_STRING("Invalid number of members in '{}' array"),
@@ -168,7 +161,9 @@ namespace {
     }
 } // namespace
 
-SoulGemGroup::SoulGemGroup(const toml::table& table)
+SoulGemGroup::SoulGemGroup(
+    const toml::table& table,
+    PluginNameTable& pluginNames)
 {
     // The nested error includes the ID value, which isn't present if this
     // fails, so we do this before the try...catch.
@@ -178,7 +173,7 @@ SoulGemGroup::SoulGemGroup(const toml::table& table)
         capacity_ = parseCapacity_(table);
         isReusable_ = parseIsReusable_(table);
         priority_ = parsePriority_(table);
-        members_ = parseMembers_(table, capacity_);
+        members_ = parseMembers_(table, capacity_, pluginNames);
     } catch (...) {
         std::throw_with_nested(SoulGemGroupError(fmt::format(
             FMT_STRING("Error while parsing soul gem group \"{}\":"sv),
@@ -14,6 +14,7 @@
 #include "../utilities/stringutils.hpp"
 #include "FormLocator.hpp"
 #include "LoadPriority.hpp"
+#include "PluginNameTable.hpp"
 #include "SoulSize.hpp"
 
 namespace RE {
@@ -37,7 +38,13 @@ private:
     MemberList members_;
 
 public:
-    explicit SoulGemGroup(const toml::table& table);
+    /**
+     * @brief Parses the soul gem group from the table. Plugin names of the
+     * members are interned into pluginNames, which must outlive the group.
+     */
+    explicit SoulGemGroup(
+        const toml::table& table,
+        PluginNameTable& pluginNames);
 
     [[nodiscard]] const IdType& id() const noexcept { return id_; }
     [[nodiscard]] bool isReusable() const noexcept { return isReusable_; }
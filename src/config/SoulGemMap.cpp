@@ -199,9 +199,50 @@ void SoulGemMap::initializeWith(
     // state.
     soulGemMap_ = std::move(capacityToGroupListMap);
     baseFormMap_ = std::move(gemToBaseFormMap);
+
+    auto groupTable = createGroupTable_();
+
+    std::lock_guard lock(groupTableMutex_);
+    groupTable_ = std::move(groupTable);
+}
+
+void SoulGemMap::clear()
+{
+    clearContainer(soulGemMap_);
+
+    std::lock_guard lock(groupTableMutex_);
+    groupTable_ = std::make_shared<const GroupTable>();
 }
 
-void SoulGemMap::clear() { clearContainer(soulGemMap_); }
+std::shared_ptr<const SoulGemMap::GroupTable>
+    SoulGemMap::createGroupTable_() const
+{
+    auto table = std::make_shared<GroupTable>();
+
+    for (SoulGemCapacityValue capacity = SoulGemCapacity::First;
+         capacity <= SoulGemCapacity::Last;
+         ++capacity) {
+        for (const auto& group : soulGemMap_[capacity]) {
+            table->ids.emplace_back(group->id().c_str());
+
+            table->properties.push_back(toPapyrusCapacity(capacity));
+            table->properties.push_back(group->isReusable() ? 1 : 0);
+            table->properties.push_back(
+                static_cast<std::int32_t>(group->priority()));
+
+            const auto membersBegin = table->members.size();
+            table->members.resize(membersBegin + GroupTable::MEMBER_COUNT);
+
+            for (const auto& [containedSoulSize, soulGem] : *group) {
+                table->members[membersBegin +
+                               static_cast<std::size_t>(containedSoulSize)] =
+                    soulGem;
+            }
+        }
+    }
+
+    return table;
+}
 
 void SoulGemMap::printContents() const
 {
@@ -4,9 +4,14 @@
 #include <compare>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
+#include <cstdint>
+
+#include <RE/B/BSFixedString.h>
+
 #include "ConcreteSoulGemGroup.hpp"
 #include "SpecificationError.hpp"
 #include "../global.hpp"
@@ -28,6 +33,34 @@ public:
     class Iterator;
     using IteratorPair = std::pair<Iterator, Iterator>;
 
+    /**
+     * @brief Contents of the soul gem map laid out as parallel arrays that can
+     * be returned to Papyrus as-is.
+     *
+     * Groups are listed by capacity (petty to grand, dual, then black), then
+     * in the order they were added to the map. Group i has:
+     *
+     * - its ID at ids[i].
+     * - PROPERTY_COUNT ints starting at properties[i * PROPERTY_COUNT]: its
+     *   capacity (see toPapyrusCapacity()), 1 if it's reusable or 0 otherwise,
+     *   and its load priority (1 = high, 2 = normal, 3 = low).
+     * - MEMBER_COUNT forms starting at members[i * MEMBER_COUNT], indexed by
+     *   contained soul size (0 = empty to 6 = black). Sizes the group doesn't
+     *   have are null.
+     *
+     * The table is built when the map is initialized and never modified
+     * afterwards.
+     */
+    struct GroupTable {
+        static constexpr std::size_t PROPERTY_COUNT = 3;
+        static constexpr std::size_t MEMBER_COUNT =
+            static_cast<std::size_t>(SoulSize::Size);
+
+        std::vector<RE::BSFixedString> ids;
+        std::vector<std::int32_t> properties;
+        std::vector<RE::TESSoulGem*> members;
+    };
+
 private:
     using SoulGemList = std::vector<RE::TESSoulGem*>;
     using ConcreteSoulGemGroupList =
@@ -45,6 +78,15 @@ private:
      * soul gem).
      */
     BaseFormMap baseFormMap_;
+    /**
+     * @brief Cached for Papyrus. Replaced (never modified) when the map
+     * changes so callers can keep using the old table while it's rebuilt.
+     */
+    std::shared_ptr<const GroupTable> groupTable_ =
+        std::make_shared<const GroupTable>();
+    mutable std::mutex groupTableMutex_;
+
+    std::shared_ptr<const GroupTable> createGroupTable_() const;
 
     friend class Iterator;
 
@@ -189,6 +231,24 @@ public:
 
     void clear();
 
+    /**
+     * @brief Returns the cached group table. Safe to call from any thread.
+     */
+    std::shared_ptr<const GroupTable> groupTable() const
+    {
+        std::lock_guard lock(groupTableMutex_);
+        return groupTable_;
+    }
+
+    /**
+     * @brief Converts the capacity to the value used by Papyrus: 1 (petty) to
+     * 5 (grand), 6 for dual soul gems and 7 for black soul gems.
+     */
+    static std::int32_t toPapyrusCapacity(const SoulGemCapacity capacity)
+    {
+        return static_cast<std::int32_t>(capacity) + 1;
+    }
+
     IteratorPair getSoulGemsWith(
         const SoulGemCapacity capacity,
         const SoulSize containedSoulSize) const
@@ -0,0 +1,196 @@
+#include "SoulTierTable.hpp"
+
+#include <array>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "../SoulValue.hpp"
+
+namespace {
+    constexpr std::array WHITE_MEMBER_SOUL_SIZES_ = {
+        SoulSize::None,
+        SoulSize::Petty,
+        SoulSize::Lesser,
+        SoulSize::Common,
+        SoulSize::Greater,
+        SoulSize::Grand,
+    };
+
+    constexpr std::array BLACK_MEMBER_SOUL_SIZES_ = {
+        SoulSize::None,
+        SoulSize::Black,
+    };
+
+    SoulTierTable::RawValueMap createVanillaRawValues_()
+    {
+        SoulTierTable::RawValueMap rawValues;
+
+        rawValues[SoulSize::None] = 0;
+        rawValues[SoulSize::Petty] = 250;
+        rawValues[SoulSize::Lesser] = 500;
+        rawValues[SoulSize::Common] = 1000;
+        rawValues[SoulSize::Greater] = 2000;
+        rawValues[SoulSize::Grand] = 3000;
+        rawValues[SoulSize::Black] = 3000;
+
+        return rawValues;
+    }
+
+    /**
+     * @brief Finds the two smaller souls with the largest combined raw value
+     * that doesn't exceed the raw value of the given soul. When multiple pairs
+     * have the same combined value, the pair with the larger first soul wins.
+     *
+     * With the vanilla raw values this produces:
+     *
+     * - Grand   = 3000 = Greater + Common
+     * - Greater = 2000 = Common + Common
+     * - Common  = 1000 = Lesser + Lesser
+     * - Lesser  = 500  = Petty + Petty
+     * - Petty   = 250 (not split)
+     */
+    SoulTierTable::SoulSplit createSoulSplit_(
+        const SoulSize soulSize,
+        const SoulTierTable::RawValueMap& rawValues)
+    {
+        SoulTierTable::SoulSplit result;
+        int bestValue = 0;
+
+        for (SoulSizeValue first = SoulSize::Petty; first < soulSize; ++first) {
+            for (SoulSizeValue second = SoulSize::Petty;
+                 second <= static_cast<SoulSize>(first);
+                 ++second) {
+                const int value = rawValues[first] + rawValues[second];
+
+                if (value > rawValues[soulSize] || value < bestValue) {
+                    continue;
+                }
+
+                // Iterating upwards means a later pair with an equal value has
+                // a larger (or equal) first soul.
+                bestValue = value;
+                result.first = first;
+                result.second = second;
+            }
+        }
+
+        return result;
+    }
+
+    SoulTierTable::SearchOrder createBestFitOrder_(const SoulSize soulSize)
+    {
+        SoulTierTable::SearchOrder order;
+
+        for (SoulGemCapacityValue capacity = toSoulGemCapacity(soulSize);
+             capacity <= SoulGemCapacity::LastWhite;
+             ++capacity) {
+            for (SoulSizeValue containedSoulSize = SoulSize::None;
+                 containedSoulSize < soulSize;
+                 ++containedSoulSize) {
+                order.push_back({capacity, containedSoulSize});
+            }
+        }
+
+        return order;
+    }
+
+    SoulTierTable::SearchOrder
+        createLeastDisplacementOrder_(const SoulSize soulSize)
+    {
+        SoulTierTable::SearchOrder order;
+
+        for (SoulSizeValue containedSoulSize = SoulSize::None;
+             containedSoulSize < soulSize;
+             ++containedSoulSize) {
+            for (SoulGemCapacityValue capacity = toSoulGemCapacity(soulSize);
+                 capacity <= SoulGemCapacity::LastWhite;
+                 ++capacity) {
+                order.push_back({capacity, containedSoulSize});
+            }
+        }
+
+        return order;
+    }
+} // namespace
+
+SoulTierTable::SoulTierTable(const RawValueMap& rawValues)
+    : rawValues_(rawValues)
+{
+    if (!areValidRawValues(rawValues)) {
+        throw std::invalid_argument("Invalid raw soul values.");
+    }
+
+    // Black souls have no entries since they're never split and don't use
+    // white soul gems.
+    for (SoulSizeValue soulSize = SoulSize::Petty;
+         soulSize <= SoulSize::LastWhite;
+         ++soulSize) {
+        splits_[soulSize] = createSoulSplit_(soulSize, rawValues_);
+        bestFitOrders_[soulSize] = createBestFitOrder_(soulSize);
+        leastDisplacementOrders_[soulSize] =
+            createLeastDisplacementOrder_(soulSize);
+    }
+}
+
+const SoulTierTable::RawValueMap& SoulTierTable::vanillaRawValues()
+{
+    static const RawValueMap rawValues = createVanillaRawValues_();
+    return rawValues;
+}
+
+const SoulTierTable& SoulTierTable::vanilla()
+{
+    static const SoulTierTable table(vanillaRawValues());
+    return table;
+}
+
+bool SoulTierTable::areValidRawValues(const RawValueMap& rawValues)
+{
+    int previousValue = 0;
+
+    for (SoulSizeValue soulSize = SoulSize::Petty;
+         soulSize <= SoulSize::LastWhite;
+         ++soulSize) {
+        if (rawValues[soulSize] <= previousValue) {
+            return false;
+        }
+
+        previousValue = rawValues[soulSize];
+    }
+
+    return rawValues[SoulSize::None] == 0 &&
+           rawValues[SoulSize::Black] == rawValues[SoulSize::Grand];
+}
+
+std::span<const SoulSize>
+    SoulTierTable::memberSoulSizes(const SoulGemCapacity capacity) noexcept
+{
+    switch (capacity) {
+    case SoulGemCapacity::Black:
+        return BLACK_MEMBER_SOUL_SIZES_;
+    case SoulGemCapacity::Dual:
+        return WHITE_MEMBER_SOUL_SIZES_;
+    default:
+        // Empty soul gem plus one member for each soul size up to the
+        // capacity.
+        return std::span(WHITE_MEMBER_SOUL_SIZES_)
+            .first(static_cast<std::size_t>(capacity + 2));
+    }
+}
+
+SoulSize SoulTierTable::toContainedSoulSize(
+    const SoulGemCapacity capacity,
+    const std::size_t index)
+{
+    const auto soulSizes = memberSoulSizes(capacity);
+
+    if (index >= soulSizes.size()) {
+        throw std::runtime_error(fmt::format(
+            FMT_STRING("Invalid member index {} for capacity {}"),
+            index,
+            capacity));
+    }
+
+    return soulSizes[index];
+}
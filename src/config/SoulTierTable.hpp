@@ -0,0 +1,117 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "../SoulSize.hpp"
+#include "../utilities/EnumArray.hpp"
+
+/**
+ * @brief Lookup tables for the soul size tiers used by the soul trap engine.
+ *
+ * The tiers themselves are fixed by the game since soul gem forms can only
+ * store the vanilla soul levels. The raw soul value of each tier is read from
+ * the configuration, and the soul split decomposition is generated from those
+ * values when the configuration is loaded.
+ *
+ * The default (vanilla) raw values share a single prebuilt table so they don't
+ * need to be regenerated on every load.
+ */
+class SoulTierTable {
+public:
+    /**
+     * @brief Raw soul value for each soul size. Black souls have the same raw
+     * value as grand souls.
+     */
+    using RawValueMap = EnumArray<SoulSize, int>;
+
+    struct SoulSplit {
+        SoulSize first = SoulSize::None;
+        SoulSize second = SoulSize::None;
+
+        bool isSplittable() const noexcept { return first != SoulSize::None; }
+    };
+
+    struct SearchEntry {
+        SoulGemCapacity capacity;
+        SoulSize containedSoulSize;
+    };
+
+    using SearchOrder = std::vector<SearchEntry>;
+
+private:
+    RawValueMap rawValues_;
+    EnumArray<SoulSize, SoulSplit> splits_;
+    EnumArray<SoulSize, SearchOrder> bestFitOrders_;
+    EnumArray<SoulSize, SearchOrder> leastDisplacementOrders_;
+
+public:
+    /**
+     * @brief Generates the tables for the given raw soul values. The values
+     * must be valid (see areValidRawValues()).
+     */
+    explicit SoulTierTable(const RawValueMap& rawValues);
+
+    static const RawValueMap& vanillaRawValues();
+    static const SoulTierTable& vanilla();
+
+    /**
+     * @brief Returns true if the white soul sizes have positive, strictly
+     * increasing raw values.
+     */
+    static bool areValidRawValues(const RawValueMap& rawValues);
+
+    /**
+     * @brief Returns the contained soul size of each member of a soul gem
+     * group with the given capacity, in configuration order.
+     */
+    static std::span<const SoulSize>
+        memberSoulSizes(SoulGemCapacity capacity) noexcept;
+
+    static std::size_t memberCount(const SoulGemCapacity capacity) noexcept
+    {
+        return memberSoulSizes(capacity).size();
+    }
+
+    /**
+     * @brief Returns the contained soul size of the member at index for a soul
+     * gem group with the given capacity. Throws if the index is out of range.
+     */
+    static SoulSize
+        toContainedSoulSize(SoulGemCapacity capacity, std::size_t index);
+
+    int rawValue(const SoulSize soulSize) const { return rawValues_[soulSize]; }
+
+    /**
+     * @brief Returns the two smaller souls a soul splits into. Black and petty
+     * souls are never split.
+     */
+    const SoulSplit& split(const SoulSize soulSize) const
+    {
+        return splits_[soulSize];
+    }
+
+    /**
+     * @brief Returns the white soul gems to search for a white soul when soul
+     * relocation is enabled, ordered by capacity first then by contained soul
+     * size.
+     *
+     * The order assumes partially filling soul gems and soul displacement are
+     * both allowed. Callers should skip entries not allowed by the current
+     * configuration.
+     */
+    const SearchOrder& bestFitOrder(const SoulSize soulSize) const
+    {
+        return bestFitOrders_[soulSize];
+    }
+
+    /**
+     * @brief Like bestFitOrder(), but ordered by contained soul size first so
+     * the smallest soul is displaced first. Used when soul relocation is
+     * disabled.
+     */
+    const SearchOrder& leastDisplacementOrder(const SoulSize soulSize) const
+    {
+        return leastDisplacementOrders_[soulSize];
+    }
+};
@@ -1,7 +1,10 @@
 #include "YASTMConfig.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <utility>
 
 #include <toml++/toml.h>
@@ -16,9 +19,15 @@
 #include "FormError.hpp"
 #include "ParseError.hpp"
 #include "SoulGemGroup.hpp"
+#include "../SoulValue.hpp"
 #include "../formatters/TESForm.hpp"
+#include "../trapsoul/ShadowTrap.hpp"
 #include "../utilities/containerutils.hpp"
+#include "../utilities/LogChannel.hpp"
+#include "../utilities/Metrics.hpp"
+#include "../utilities/MetricsExporter.hpp"
 #include "../utilities/printerror.hpp"
+#include "../utilities/stringutils.hpp"
 
 using namespace std::literals;
 
@@ -27,7 +36,8 @@ namespace {
     void readGlobalVariableConfigs_(
         const KeyType key,
         const toml::node_view<toml::node>& table,
-        YASTMConfig::GlobalVarMap<KeyType>& map)
+        YASTMConfig::GlobalVarMap<KeyType>& map,
+        PluginNameTable& pluginNames)
     {
         const auto keyName = toString(key);
         const auto tomlKeyName = std::string(keyName) + "Global";
@@ -38,7 +48,7 @@ namespace {
             formIdArray != nullptr) {
             if (map.contains(key)) {
                 try {
-                    map.at(key).setFromTomlArray(*formIdArray);
+                    map.at(key).setFromTomlArray(*formIdArray, pluginNames);
                 } catch (const ParseError& error) {
                     LOG_ERROR_FMT(
                         "Error while reading configuration for key \"{}\":"sv,
@@ -124,6 +134,168 @@ namespace {
         }
     }
 
+    void readLogLevel_(
+        const toml::node& node,
+        const std::string_view keyName,
+        const std::function<void(spdlog::level::level_enum)>& setLevel)
+    {
+        const auto levelName = node.value<std::string>();
+
+        if (!levelName.has_value()) {
+            return;
+        }
+
+        if (const auto level = fromLogLevelString(*levelName);
+            level.has_value()) {
+            setLevel(*level);
+        } else {
+            LOG_WARN_FMT(
+                "Invalid log level \"{}\" for logging key \"{}\"."sv,
+                *levelName,
+                keyName);
+        }
+    }
+
+    void readLoggingConfig_(const toml::node_view<toml::node>& table)
+    {
+        auto& registry = LogChannelRegistry::getInstance();
+        const auto loggingTable = table.as_table();
+
+        if (loggingTable == nullptr) {
+            return;
+        }
+
+        // Keys are matched case-insensitively, like the values. The global
+        // level is applied first so individual channels can override it.
+        for (const auto& [key, node] : *loggingTable) {
+            if (getLowerString(key.str()) == "level"sv) {
+                readLogLevel_(node, key.str(), [&](const auto level) {
+                    registry.setLevel(level);
+                });
+            }
+        }
+
+        for (const auto& [key, node] : *loggingTable) {
+            if (const auto channel = fromLogChannelString(key.str());
+                channel.has_value()) {
+                readLogLevel_(node, key.str(), [&](const auto level) {
+                    registry.setLevel(*channel, level);
+                });
+            }
+        }
+
+        if (const auto seconds = table["rateLimitSeconds"sv].value<double>();
+            seconds.has_value()) {
+            registry.setRateLimitWindow(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::duration<double>(std::max(*seconds, 0.0))));
+        }
+
+        LOG_INFO("Log channel levels:");
+        forEachLogChannel([&](const LogChannel channel) {
+            LOG_INFO_FMT(
+                "- {} = {}"sv,
+                toString(channel),
+                spdlog::level::to_string_view(registry.level(channel)));
+        });
+    }
+
+    void readMetricsConfig_(const toml::node_view<toml::node>& table)
+    {
+        auto& exporter = MetricsExporter::getInstance();
+
+        if (!table["enabled"sv].value_or(false)) {
+            exporter.stop();
+            LOG_INFO("Metrics export is disabled.");
+            return;
+        }
+
+        const auto intervalSeconds = std::max<std::int64_t>(
+            table["intervalSeconds"sv].value_or<std::int64_t>(10),
+            1);
+
+        exporter.start(
+            std::filesystem::path("Data/SKSE/Plugins/YASTM.metrics"sv),
+            std::chrono::seconds(intervalSeconds));
+    }
+
+    void readShadowConfig_(const toml::node_view<toml::node>& table)
+    {
+        auto& runner = ShadowTrapRunner::getInstance();
+
+        if (!table["enabled"sv].value_or(false)) {
+            runner.stop();
+            LOG_INFO("Shadow mode is disabled.");
+            return;
+        }
+
+        ShadowStrategy strategy;
+
+        if (const auto techniqueName =
+                table["soulShrinkingTechnique"sv].value<std::string>();
+            techniqueName.has_value()) {
+            for (const auto technique :
+                 {SoulShrinkingTechnique::None,
+                  SoulShrinkingTechnique::Shrink,
+                  SoulShrinkingTechnique::Split}) {
+                if (toString(technique) == techniqueName.value()) {
+                    strategy.soulShrinkingTechnique = technique;
+                }
+            }
+
+            if (!strategy.soulShrinkingTechnique.has_value()) {
+                LOG_CHANNEL_WARN_FMT(
+                    LogChannel::Config,
+                    "Unknown shadow soul shrinking technique \"{}\". Using "
+                    "the production setting.",
+                    techniqueName.value());
+            }
+        }
+
+        strategy.allowPartiallyFillingSoulGems =
+            table["allowPartiallyFillingSoulGems"sv].value<bool>();
+        strategy.allowSoulDisplacement =
+            table["allowSoulDisplacement"sv].value<bool>();
+        strategy.allowSoulRelocation =
+            table["allowSoulRelocation"sv].value<bool>();
+
+        const auto sampleEvery = std::max<std::int64_t>(
+            table["sampleEvery"sv].value_or<std::int64_t>(10),
+            1);
+        const auto maxPendingRuns = std::max<std::int64_t>(
+            table["maxPendingRuns"sv].value_or<std::int64_t>(16),
+            1);
+
+        runner.start(
+            strategy,
+            static_cast<std::uint64_t>(sampleEvery),
+            static_cast<std::size_t>(maxPendingRuns));
+    }
+
+    SoulTierTable::RawValueMap
+        readSoulValuesConfig_(const toml::node_view<toml::node>& table)
+    {
+        const std::array keys = {
+            std::pair{SoulSize::Petty, "petty"sv},
+            std::pair{SoulSize::Lesser, "lesser"sv},
+            std::pair{SoulSize::Common, "common"sv},
+            std::pair{SoulSize::Greater, "greater"sv},
+            std::pair{SoulSize::Grand, "grand"sv},
+        };
+
+        auto rawValues = SoulTierTable::vanillaRawValues();
+
+        for (const auto& [soulSize, key] : keys) {
+            rawValues[soulSize] = static_cast<int>(
+                table[key].value_or<std::int64_t>(rawValues[soulSize]));
+        }
+
+        // Black souls are always worth the same as grand souls.
+        rawValues[SoulSize::Black] = rawValues[SoulSize::Grand];
+
+        return rawValues;
+    }
+
     const std::array SOULTRAP_THRESHOLD_SOULSIZE_KEYS_ = {
         IntConfigKey::SoulTrapThresholdPetty,
         IntConfigKey::SoulTrapThresholdLesser,
@@ -179,16 +351,33 @@ void YASTMConfig::loadYASTMConfigFile_()
         const auto yastmTable = table["YASTM"];
 
         forEachBoolConfigKey([&, this](const BoolConfigKey key) {
-            readGlobalVariableConfigs_(key, yastmTable, globalBools_);
+            readGlobalVariableConfigs_(
+                key,
+                yastmTable,
+                globalBools_,
+                pluginNames_);
         });
 
         forEachEnumConfigKey([&, this](const EnumConfigKey key) {
-            readGlobalVariableConfigs_(key, yastmTable, globalEnums_);
+            readGlobalVariableConfigs_(
+                key,
+                yastmTable,
+                globalEnums_,
+                pluginNames_);
         });
 
         forEachIntConfigKey([&, this](const IntConfigKey key) {
-            readGlobalVariableConfigs_(key, yastmTable, globalInts_);
+            readGlobalVariableConfigs_(
+                key,
+                yastmTable,
+                globalInts_,
+                pluginNames_);
         });
+
+        readLoggingConfig_(table["logging"sv]);
+        readMetricsConfig_(table["metrics"sv]);
+        setSoulTiers_(readSoulValuesConfig_(table["soulValues"sv]));
+        readShadowConfig_(table["shadow"sv]);
     } catch (const toml::parse_error& error) {
         LOG_WARN_FMT(
             "Error while parsing general configuration file \"{}\": {}",
@@ -288,7 +477,7 @@ std::size_t
             try {
                 elem.visit([&, this](auto&& el) {
                     if constexpr (toml::is_table<decltype(el)>) {
-                        soulGemGroupList_.emplace_back(el);
+                        soulGemGroupList_.emplace_back(el, pluginNames_);
                         // We've found a valid soul gem group!
                         ++validSoulGemGroupsCount;
                     } else {
@@ -305,6 +494,45 @@ std::size_t
     return validSoulGemGroupsCount;
 }
 
+void YASTMConfig::setSoulTiers_(const SoulTierTable::RawValueMap& rawValues)
+{
+    if (!SoulTierTable::areValidRawValues(rawValues)) {
+        LOG_CHANNEL_WARN(
+            LogChannel::Config,
+            "Soul values must be positive and strictly increasing from petty "
+            "to grand. Using vanilla soul values.");
+        customSoulTiers_.reset();
+        soulTiers_ = &SoulTierTable::vanilla();
+    } else if (rawValues == SoulTierTable::vanillaRawValues()) {
+        customSoulTiers_.reset();
+        soulTiers_ = &SoulTierTable::vanilla();
+    } else {
+        soulTiers_ = &customSoulTiers_.emplace(rawValues);
+    }
+
+    for (SoulSizeValue soulSize = SoulSize::Petty;
+         soulSize <= SoulSize::LastWhite;
+         ++soulSize) {
+        const auto& split = soulTiers_->split(soulSize);
+
+        if (split.isSplittable()) {
+            LOG_CHANNEL_INFO_FMT(
+                LogChannel::Config,
+                "Soul value: {:t} = {} (splits into {:t} + {:t})",
+                static_cast<SoulSize>(soulSize),
+                soulTiers_->rawValue(soulSize),
+                split.first,
+                split.second);
+        } else {
+            LOG_CHANNEL_INFO_FMT(
+                LogChannel::Config,
+                "Soul value: {:t} = {}",
+                static_cast<SoulSize>(soulSize),
+                soulTiers_->rawValue(soulSize));
+        }
+    }
+}
+
 void YASTMConfig::checkDllDependencies(const SKSE::LoadInterface* loadInterface)
 {
     forEachDLLDependencyKey([&, this](
@@ -339,6 +567,7 @@ void YASTMConfig::loadConfig(RE::TESDataHandler* const dataHandler)
 {
     static bool isFirstRun = true;
     std::lock_guard lock(mutex_);
+    const auto begin = std::chrono::steady_clock::now();
 
     if (!isFirstRun) {
         clear();
@@ -347,20 +576,31 @@ void YASTMConfig::loadConfig(RE::TESDataHandler* const dataHandler)
     isFirstRun = false;
     loadConfigFiles_();
     loadGameForms_(dataHandler);
+
+    Metrics::getInstance().recordConfigLoad(
+        std::chrono::steady_clock::now() - begin);
 }
 
 void YASTMConfig::clear()
 {
     LOG_INFO("Clearing configuration data...");
 
+    LogChannelRegistry::getInstance().flushSuppressedSummaries();
+
     // Clear the loaded data (form ID and game form) but leave the default
     // values intact.
     for (auto& [key, globalBool] : globalBools_) { globalBool.clear(); }
     for (auto& [key, globalEnum] : globalEnums_) { globalEnum.clear(); }
     for (auto& [key, globalInt] : globalInts_) { globalInt.clear(); }
 
+    // Dry runs read the soul gem map, so they must be stopped first.
+    ShadowTrapRunner::getInstance().stop();
     clearContainer(soulGemGroupList_);
     soulGemMap_.clear();
+    customSoulTiers_.reset();
+    soulTiers_ = &SoulTierTable::vanilla();
+    // Must be cleared after everything holding form IDs.
+    pluginNames_.clear();
     // This doesn't need to be cleared because the list won't change until the
     // game fully restarts.
     //dependencies_ =
@@ -393,7 +633,7 @@ void YASTMConfig::createSoulGemMap_(RE::TESDataHandler* const dataHandler)
     soulGemMap_.printContents();
 }
 
-void YASTMConfig::Snapshot::printValues_() const
+void ConfigSnapshot::printValues_() const
 {
 #if !defined(NDEBUG)
     LOG_TRACE("Found configuration:");
@@ -415,7 +655,7 @@ void YASTMConfig::Snapshot::printValues_() const
 #endif // !defined(NDEBUG)
 }
 
-void YASTMConfig::Snapshot::printValues_(
+void ConfigSnapshot::printValues_(
 // Disable the unreferenced parameter warning in release mode.
 #if defined(NDEBUG)
 #    pragma warning(disable:4100)
@@ -465,7 +705,7 @@ void YASTMConfig::Snapshot::printValues_(
 #endif // !defined(NDEBUG)
 }
 
-void YASTMConfig::Snapshot::initialize_(const YASTMConfig& config)
+void ConfigSnapshot::initialize_(const YASTMConfig& config)
 {
     forEachBoolConfigKey([&, this](const BoolConfigKey key) {
         configBools_[static_cast<std::size_t>(key)] = config.getGlobalBool(key);
@@ -482,14 +722,14 @@ void YASTMConfig::Snapshot::initialize_(const YASTMConfig& config)
     });
 }
 
-YASTMConfig::Snapshot::Snapshot(const YASTMConfig& config)
+ConfigSnapshot::ConfigSnapshot(const YASTMConfig& config)
 {
     initialize_(config);
     normalize_();
     printValues_();
 }
 
-YASTMConfig::Snapshot::Snapshot(
+ConfigSnapshot::ConfigSnapshot(
     const YASTMConfig& config,
     const int soulTrapLevel)
 {
@@ -554,7 +794,7 @@ YASTMConfig::Snapshot::Snapshot(
     }
 }
 
-void YASTMConfig::Snapshot::normalize_()
+void ConfigSnapshot::normalize_()
 {
     using EC = EnumConfigKey;
     using IC = IntConfigKey;
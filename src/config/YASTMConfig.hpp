@@ -1,8 +1,8 @@
 #pragma once
 
-#include <bitset>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -13,13 +13,16 @@
 
 #include "../global.hpp"
 #include "../SoulSize.hpp"
+#include "ConfigSnapshot.hpp"
 #include "ConfigKey/BoolConfigKey.hpp"
 #include "ConfigKey/EnumConfigKey.hpp"
 #include "ConfigKey/IntConfigKey.hpp"
 #include "DllDependencyKey.hpp"
 #include "GlobalVarForm.hpp"
+#include "PluginNameTable.hpp"
 #include "SoulGemGroup.hpp"
 #include "SoulGemMap.hpp"
+#include "SoulTierTable.hpp"
 
 namespace RE {
     class TESDataHandler;
@@ -29,12 +32,19 @@ namespace RE {
 
 class YASTMConfig {
 public:
-    class Snapshot;
+    using Snapshot = ConfigSnapshot;
     using SoulGemGroupList = std::vector<SoulGemGroup>;
     template <typename KeyType>
     using GlobalVarMap = std::unordered_map<KeyType, GlobalVarForm<KeyType>>;
 
 private:
+    /**
+     * @brief Interned plugin names for all form IDs read from the
+     * configuration files. Declared first so it outlives everything that refers
+     * to it.
+     */
+    PluginNameTable pluginNames_;
+
     GlobalVarMap<BoolConfigKey> globalBools_;
     GlobalVarMap<EnumConfigKey> globalEnums_;
     GlobalVarMap<IntConfigKey> globalInts_;
@@ -42,6 +52,13 @@ private:
     SoulGemGroupList soulGemGroupList_;
     SoulGemMap soulGemMap_;
 
+    /**
+     * @brief Soul tier table generated from non-vanilla raw soul values. Unset
+     * when the vanilla values are used.
+     */
+    std::optional<SoulTierTable> customSoulTiers_;
+    const SoulTierTable* soulTiers_ = &SoulTierTable::vanilla();
+
     std::unordered_map<DLLDependencyKey, const SKSE::PluginInfo*> dependencies_;
     mutable std::mutex mutex_;
 
@@ -59,6 +76,7 @@ private:
 
     void loadYASTMConfigFile_();
     void loadIndividualConfigFiles_();
+    void setSoulTiers_(const SoulTierTable::RawValueMap& rawValues);
     std::size_t readAndCountSoulGemGroupConfigs_(const toml::table& table);
 
     void loadGlobalForms_(RE::TESDataHandler* dataHandler);
@@ -121,53 +139,9 @@ public:
     }
 
     const SoulGemMap& soulGemMap() const noexcept { return soulGemMap_; }
-
-    /**
-     * @brief Represents a snapshot of the configuration at a certain point in
-     * time.
-     */
-    class Snapshot {
-        std::bitset<static_cast<std::size_t>(BoolConfigKey::Count)>
-            configBools_;
-        std::unordered_map<EnumConfigKey, EnumConfigUnderlyingType>
-            configEnums_;
-        std::unordered_map<IntConfigKey, int> configInts_;
-
-        void printValues_() const;
-        void printValues_(
-            const decltype(configBools_)& overrideBools,
-            const decltype(configEnums_)& overrideEnums) const;
-        void initialize_(const YASTMConfig& config);
-        void normalize_();
-
-    public:
-        explicit Snapshot(const YASTMConfig& config);
-        explicit Snapshot(const YASTMConfig& config, int soulTrapLevel);
-
-        template <EnumConfigKey K>
-        auto get() const;
-
-        bool operator[](BoolConfigKey key) const;
-        int operator[](IntConfigKey key) const;
-    };
+    const SoulTierTable& soulTiers() const noexcept { return *soulTiers_; }
 };
 
-template <EnumConfigKey K>
-inline auto YASTMConfig::Snapshot::get() const
-{
-    return static_cast<EnumConfigKeyTypeMap<K>::type>(configEnums_.at(K));
-}
-
-inline bool YASTMConfig::Snapshot::operator[](const BoolConfigKey key) const
-{
-    return configBools_[static_cast<std::size_t>(key)];
-}
-
-inline int YASTMConfig::Snapshot::operator[](const IntConfigKey key) const
-{
-    return configInts_.at(key);
-}
-
 class YASTMConfigLoadError : public std::runtime_error {
 public:
     explicit YASTMConfigLoadError(const std::string& message)
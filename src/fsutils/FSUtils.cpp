@@ -97,7 +97,16 @@ namespace {
         filePath /= path.c_str();
 
         try {
-            return ConfigManager::getInstance().openConfig(filePath);
+            const auto handle =
+                ConfigManager::getInstance().openConfig(filePath);
+
+            LOG_CHANNEL_DEBUG_FMT(
+                LogChannel::FSUtils,
+                "Opened config {} with handle {}",
+                filePath.string(),
+                handle);
+
+            return handle;
         } catch (const std::exception& error) {
             std::stringstream stream;
 
@@ -124,6 +133,12 @@ namespace {
         try {
             ConfigManager::getInstance().saveConfig(handle, filePath);
 
+            LOG_CHANNEL_DEBUG_FMT(
+                LogChannel::FSUtils,
+                "Saved config handle {} to {}",
+                handle,
+                filePath.string());
+
             return true;
         } catch (const std::exception& error) {
             std::stringstream stream;
@@ -146,6 +161,11 @@ namespace {
     {
         try {
             ConfigManager::getInstance().closeConfig(handle);
+
+            LOG_CHANNEL_DEBUG_FMT(
+                LogChannel::FSUtils,
+                "Closed config handle {}",
+                handle);
         } catch (const std::exception& error) {
             std::stringstream stream;
 
@@ -170,12 +190,9 @@ namespace {
         }
 
         try {
-            auto maybeConfig = ConfigManager::getInstance().getConfig(handle);
-
-            if (maybeConfig.has_value()) {
-                auto& config = maybeConfig.value().get();
-
-                return config.has(key);
+            if (const auto config =
+                    ConfigManager::getInstance().getConfig(handle)) {
+                return config->has(key);
             }
         } catch (const std::exception& error) {
             std::stringstream stream;
@@ -205,11 +222,9 @@ namespace {
         }
 
         try {
-            auto maybeConfig = ConfigManager::getInstance().getConfig(handle);
-
-            if (maybeConfig.has_value()) {
-                auto& config = maybeConfig.value().get();
-                config.set(key, value);
+            if (const auto config =
+                    ConfigManager::getInstance().getConfig(handle)) {
+                config->set(key, value);
 
                 return true;
             }
@@ -241,11 +256,9 @@ namespace {
         }
 
         try {
-            auto maybeConfig = ConfigManager::getInstance().getConfig(handle);
-
-            if (maybeConfig.has_value()) {
-                auto& config = maybeConfig.value().get();
-                return config.get(key, defaultValue);
+            if (const auto config =
+                    ConfigManager::getInstance().getConfig(handle)) {
+                return config->get(key, defaultValue);
             }
         } catch (const std::exception& error) {
             std::stringstream stream;
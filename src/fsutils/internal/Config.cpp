@@ -1,7 +1,10 @@
 #include "Config.hpp"
 
+#include <cstdint>
 #include <fstream>
 
+#include "../../utilities/Metrics.hpp"
+
 // Note to Future Me: Do not handle exceptions here. Let them propagate to the
 //                    actual Papyrus call so that we have access to the
 //                    Papyrus VM context for logging.
@@ -17,5 +20,12 @@ bool Config::writeToDisk(const std::filesystem::path& filePath) const
     std::ofstream configFile(filePath);
     configFile << data_;
 
+    if (const auto bytesWritten =
+            static_cast<std::streamoff>(configFile.tellp());
+        bytesWritten > 0) {
+        Metrics::getInstance().addFSUtilsBytesWritten(
+            static_cast<std::uint64_t>(bytesWritten));
+    }
+
     return true;
 }
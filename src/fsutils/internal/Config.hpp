@@ -1,6 +1,9 @@
 #pragma once
 
+#include <filesystem>
+#include <mutex>
 #include <shared_mutex>
+#include <string_view>
 
 #include <toml++/toml.h>
 
@@ -1,8 +1,12 @@
 #include "ConfigManager.hpp"
 
+#include <chrono>
 #include <filesystem>
+#include <memory>
+#include <system_error>
+#include <utility>
 
-#include "../../utilities/containerutils.hpp"
+#include "../../utilities/Metrics.hpp"
 
 // Note to Future Me: Do not handle exceptions here. Let them propagate to the
 //                    actual Papyrus call so that we have access to the
@@ -10,71 +14,111 @@
 
 using HandleType = ConfigManager::HandleType;
 
-HandleType ConfigManager::openConfig(const std::filesystem::path& filePath)
+namespace {
+    /**
+     * @brief Locks the mutex with the given lock type, recording the time
+     * spent waiting for it.
+     */
+    template <typename LockType>
+    LockType lockMutex_(std::shared_mutex& mutex)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        LockType lock(mutex);
+        Metrics::getInstance().recordFSUtilsLockWait(
+            std::chrono::steady_clock::now() - begin);
+
+        return lock;
+    }
+} // namespace
+
+HandleType ConfigManager::addConfig_(std::shared_ptr<Config> config)
 {
-    std::unique_lock lock(mutex_);
+    const auto handle = nextHandle_++;
+    configs_.emplace(handle, std::move(config));
+    Metrics::getInstance().setFSUtilsOpenHandles(configs_.size());
 
-    // Do NOT use the public function otherwise we'll end up in a deadlock.
-    const auto handle = getNextHandle_();
-    configs_.emplace(handle, filePath.string());
     return handle;
 }
 
+HandleType ConfigManager::openConfig(const std::filesystem::path& filePath)
+{
+    // Parse the file before locking so other handles aren't blocked on disk
+    // access.
+    auto config = std::make_shared<Config>(filePath.string());
+
+    std::error_code error;
+
+    if (const auto fileSize = std::filesystem::file_size(filePath, error);
+        !error) {
+        Metrics::getInstance().addFSUtilsBytesRead(fileSize);
+    }
+
+    auto lock = lockMutex_<std::unique_lock<std::shared_mutex>>(mutex_);
+
+    return addConfig_(std::move(config));
+}
+
 HandleType ConfigManager::createConfig()
 {
-    std::unique_lock lock(mutex_);
+    auto config = std::make_shared<Config>();
 
-    // Do NOT use the public function otherwise we'll end up in a deadlock.
-    const auto handle = getNextHandle_();
-    configs_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(handle),
-        std::tuple<>());
+    auto lock = lockMutex_<std::unique_lock<std::shared_mutex>>(mutex_);
 
-    return handle;
+    return addConfig_(std::move(config));
 }
 
 void ConfigManager::closeConfig(const HandleType handle)
 {
-    std::unique_lock lock(mutex_);
+    std::shared_ptr<Config> config;
+
+    {
+        auto lock = lockMutex_<std::unique_lock<std::shared_mutex>>(mutex_);
+
+        if (const auto it = configs_.find(handle); it != configs_.end()) {
+            // Destroyed outside the lock if this is the last reference.
+            config = std::move(it->second);
+            configs_.erase(it);
+        }
 
-    configs_.erase(handle);
+        Metrics::getInstance().setFSUtilsOpenHandles(configs_.size());
+    }
 }
 
 bool ConfigManager::saveConfig(
     const HandleType handle,
     const std::filesystem::path& filePath) const
 {
-    std::shared_lock lock(mutex_);
-
-    auto it = configs_.find(handle);
+    const auto config = getConfig(handle);
 
-    if (it == configs_.end()) {
+    if (config == nullptr) {
         // Handle does not exist.
         return false;
     }
 
-    const auto& config = it->second;
-    config.writeToDisk(filePath);
+    // The config has its own lock so writing it doesn't block the other
+    // handles.
+    config->writeToDisk(filePath);
     return true;
 }
 
-std::optional<std::reference_wrapper<Config>>
-    ConfigManager::getConfig(const HandleType handle)
+std::shared_ptr<Config> ConfigManager::getConfig(const HandleType handle) const
 {
-    std::shared_lock lock(mutex_);
-
-    auto it = configs_.find(handle);
+    auto lock = lockMutex_<std::shared_lock<std::shared_mutex>>(mutex_);
 
-    if (it == configs_.end()) {
-        return std::nullopt;
+    if (const auto it = configs_.find(handle); it != configs_.end()) {
+        return it->second;
     }
 
-    return it->second;
+    return nullptr;
 }
 
 void ConfigManager::closeAllConfigs()
 {
-    std::unique_lock handle(mutex_);
-    clearContainer(configs_);
+    decltype(configs_) configs;
+
+    {
+        auto lock = lockMutex_<std::unique_lock<std::shared_mutex>>(mutex_);
+        configs_.swap(configs);
+        Metrics::getInstance().setFSUtilsOpenHandles(0);
+    }
 }
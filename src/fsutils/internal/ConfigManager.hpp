@@ -1,17 +1,12 @@
 #pragma once
 
+#include <filesystem>
 #include <map>
+#include <memory>
 #include <shared_mutex>
-#include <optional>
 
 #include "Config.hpp"
 
-namespace std {
-    namespace filesystem {
-        class path;
-    }
-} // namespace std
-
 class ConfigManager {
 public:
     using HandleType = int;
@@ -23,7 +18,16 @@ private:
     ConfigManager& operator=(const ConfigManager&) = delete;
     ConfigManager& operator=(ConfigManager&) = delete;
 
-    std::map<HandleType, Config> configs_;
+    /**
+     * Configs are shared so callers can keep using one after releasing the
+     * manager lock, even if it gets closed in the meantime.
+     */
+    std::map<HandleType, std::shared_ptr<Config>> configs_;
+    /**
+     * Handles are never reused (until the game restarts) so a stale handle
+     * held by a script can't refer to a config opened later.
+     */
+    HandleType nextHandle_ = 1;
     mutable std::shared_mutex mutex_;
 
     /**
@@ -45,15 +49,11 @@ private:
     }
 
     /**
-     * Returns the value of the next handle that will be created.
+     * Reserves the next handle and adds the config with that handle.
      *
-     * Does not lock mutex. All internal users should use this instead of the
-     * public version.
+     * Does not lock mutex. Callers must hold a unique lock.
      */
-    HandleType getNextHandle_() const noexcept
-    {
-        return getLargestHandle_() + 1;
-    }
+    HandleType addConfig_(std::shared_ptr<Config> config);
 
 public:
     static ConfigManager& getInstance()
@@ -69,7 +69,11 @@ public:
     bool saveConfig(HandleType handle, const std::filesystem::path& path) const;
     void closeAllConfigs();
 
-    std::size_t size() const noexcept { return configs_.size(); }
+    std::size_t size() const
+    {
+        std::shared_lock lock(mutex_);
+        return configs_.size();
+    }
 
     /**
      * Returns the largest handle that currently exists. Or 0 if there are no
@@ -87,8 +91,12 @@ public:
     HandleType getNextHandle() const
     {
         std::shared_lock lock(mutex_);
-        return getNextHandle_();
+        return nextHandle_;
     }
 
-    std::optional<std::reference_wrapper<Config>> getConfig(HandleType handle);
+    /**
+     * Returns the config with the given handle, or nullptr if it doesn't
+     * exist. The returned config stays valid even if it's closed afterwards.
+     */
+    std::shared_ptr<Config> getConfig(HandleType handle) const;
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "utilities/LogChannel.hpp"
+
 #define DLLEXPORT __declspec(dllexport)
 
 // These macros allow potentially zero-overhead log calls (compiled out)
@@ -29,6 +31,63 @@
 #define LOG_ERROR_FMT(str, ...) LOG_ERROR(FMT_STRING(str), __VA_ARGS__)
 #define LOG_CRITICAL_FMT(str, ...) LOG_CRITICAL(FMT_STRING(str), __VA_ARGS__)
 
+// Channel log calls are always compiled in, but are gated by the runtime log
+// level of the given LogChannel. Arguments are only evaluated (and the message
+// only formatted) when the channel allows the level.
+#define LOG_CHANNEL_CALL(channel, lvl, fn, ...)                    \
+    do {                                                           \
+        if (LogChannelRegistry::getInstance().shouldLog(           \
+                channel,                                           \
+                spdlog::level::lvl)) {                             \
+            SKSE::log::fn(__VA_ARGS__);                            \
+        }                                                          \
+    } while (false)
+
+#define LOG_CHANNEL_TRACE(channel, ...) \
+    LOG_CHANNEL_CALL(channel, trace, trace, __VA_ARGS__)
+#define LOG_CHANNEL_DEBUG(channel, ...) \
+    LOG_CHANNEL_CALL(channel, debug, debug, __VA_ARGS__)
+#define LOG_CHANNEL_INFO(channel, ...) \
+    LOG_CHANNEL_CALL(channel, info, info, __VA_ARGS__)
+#define LOG_CHANNEL_WARN(channel, ...) \
+    LOG_CHANNEL_CALL(channel, warn, warn, __VA_ARGS__)
+#define LOG_CHANNEL_ERROR(channel, ...) \
+    LOG_CHANNEL_CALL(channel, err, error, __VA_ARGS__)
+
+#define LOG_CHANNEL_TRACE_FMT(channel, str, ...) \
+    LOG_CHANNEL_TRACE(channel, FMT_STRING(str), __VA_ARGS__)
+#define LOG_CHANNEL_DEBUG_FMT(channel, str, ...) \
+    LOG_CHANNEL_DEBUG(channel, FMT_STRING(str), __VA_ARGS__)
+#define LOG_CHANNEL_INFO_FMT(channel, str, ...) \
+    LOG_CHANNEL_INFO(channel, FMT_STRING(str), __VA_ARGS__)
+#define LOG_CHANNEL_WARN_FMT(channel, str, ...) \
+    LOG_CHANNEL_WARN(channel, FMT_STRING(str), __VA_ARGS__)
+#define LOG_CHANNEL_ERROR_FMT(channel, str, ...) \
+    LOG_CHANNEL_ERROR(channel, FMT_STRING(str), __VA_ARGS__)
+
+// Like the channel log calls, but an identical message from the same call site
+// is logged at most once within the channel registry's rate limit window.
+// Repeats are counted and summarized. Use these for messages that may repeat
+// on hot paths.
+#define LOG_CHANNEL_LIMITED_CALL(channel, lvl, str, ...)                  \
+    do {                                                                  \
+        auto& logChannelRegistry_ = LogChannelRegistry::getInstance();    \
+        if (logChannelRegistry_.shouldLog(channel, spdlog::level::lvl)) { \
+            logChannelRegistry_.logRateLimited(                           \
+                channel,                                                  \
+                spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},  \
+                spdlog::level::lvl,                                       \
+                fmt::format(FMT_STRING(str), __VA_ARGS__));               \
+        }                                                                 \
+    } while (false)
+
+#define LOG_CHANNEL_DEBUG_LIMITED_FMT(channel, str, ...) \
+    LOG_CHANNEL_LIMITED_CALL(channel, debug, str, __VA_ARGS__)
+#define LOG_CHANNEL_INFO_LIMITED_FMT(channel, str, ...) \
+    LOG_CHANNEL_LIMITED_CALL(channel, info, str, __VA_ARGS__)
+#define LOG_CHANNEL_WARN_LIMITED_FMT(channel, str, ...) \
+    LOG_CHANNEL_LIMITED_CALL(channel, warn, str, __VA_ARGS__)
+
 #define VERSION_CODE(primary, secondary, sub)                 \
     (((primary & 0xFFF) << 20) | ((secondary & 0xFFF) << 8) | \
      ((sub & 0xFF) << 0))
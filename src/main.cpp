@@ -33,11 +33,13 @@ bool setUpLogging()
         true);
     auto log = std::make_shared<spdlog::logger>("global log"s, std::move(sink));
 
-#ifndef NDEBUG
+    // The logger accepts everything. Filtering of channel messages is done by
+    // LogChannelRegistry, and unchanneled LOG_TRACE/LOG_DEBUG calls are already
+    // compiled out in release builds.
     log->set_level(spdlog::level::trace);
+#ifndef NDEBUG
     log->flush_on(spdlog::level::trace);
 #else
-    log->set_level(spdlog::level::info);
     log->flush_on(spdlog::level::info);
 #endif
 
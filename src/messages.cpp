@@ -0,0 +1,23 @@
+#include "messages.hpp"
+
+#include "config/DllDependencyKey.hpp"
+#include "config/YASTMConfig.hpp"
+
+const char* getMessage(const MiscMessage key)
+{
+    switch (key) {
+    case MiscMessage::TimeTakenToTrapSoul:
+        if (YASTMConfig::getInstance().isDllLoaded(
+                DLLDependencyKey::ScaleformTranslationPlusPlus)) {
+            return "$YASTM_Notification_TimeTakenToTrapSoul{{{:.7f}}}";
+        }
+
+        return "Time taken to trap soul: {:.7f} seconds";
+    case MiscMessage::CannotFindSoulGemBaseForm:
+        // We don't want a translation string for an error message that should
+        // never happen.
+        return "ERROR: Soul gem not consumed because no base form was found.";
+    }
+
+    return "";
+}
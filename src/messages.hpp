@@ -1,8 +1,5 @@
 #pragma once
 
-#include "config/DllDependencyKey.hpp"
-#include "config/YASTMConfig.hpp"
-
 enum class SoulTrapSuccessMessage {
     SoulCaptured,
     SoulDisplaced,
@@ -99,21 +96,4 @@ inline constexpr const char*
     return "";
 }
 
-inline const char* getMessage(const MiscMessage key)
-{
-    switch (key) {
-    case MiscMessage::TimeTakenToTrapSoul:
-        if (YASTMConfig::getInstance().isDllLoaded(
-                DLLDependencyKey::ScaleformTranslationPlusPlus)) {
-            return "$YASTM_Notification_TimeTakenToTrapSoul{{{:.7f}}}";
-        }
-
-        return "Time taken to trap soul: {:.7f} seconds";
-    case MiscMessage::CannotFindSoulGemBaseForm:
-        // We don't want a translation string for an error message that should
-        // never happen.
-        return "ERROR: Soul gem not consumed because no base form was found.";
-    }
-
-    return "";
-}
+const char* getMessage(MiscMessage key);
@@ -0,0 +1,402 @@
+#include "GameSoulTrapBackend.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include <cassert>
+
+#include <RE/A/Actor.h>
+#include <RE/M/Misc.h>
+#include <RE/P/PlayerCharacter.h>
+#include <RE/S/SoulsTrapped.h>
+#include <RE/T/TESBoundObject.h>
+#include <RE/T/TESForm.h>
+#include <RE/T/TESObjectREFR.h>
+#include <RE/T/TESSoulGem.h>
+#include <SKSE/SKSE.h>
+
+#include "trapsoul.hpp"
+#include "types.hpp"
+#include "SearchResult.hpp"
+#include "../global.hpp"
+#include "../config/ConfigKey/BoolConfigKey.hpp"
+#include "../config/YASTMConfig.hpp"
+#include "../formatters/TESSoulGem.hpp"
+#include "../utilities/Metrics.hpp"
+#include "../utilities/misc.hpp"
+#include "../utilities/native.hpp"
+
+using namespace std::literals;
+
+namespace {
+    [[nodiscard]] RE::ExtraDataList*
+        getFirstExtraDataList_(RE::InventoryEntryData* const entryData)
+    {
+        const auto extraLists = entryData->extraLists;
+
+        if (extraLists == nullptr || extraLists->empty()) {
+            return nullptr;
+        }
+
+        return extraLists->front();
+    }
+
+    /**
+     * @brief The soul gems in the caster's inventory. The inventory is scanned
+     * when first needed and again after a soul gem has been replaced.
+     */
+    class Inventory_ : public SoulTrapBackend::Inventory {
+        RE::Actor* const caster_;
+        const ConfigSnapshot& config_;
+        UnorderedInventoryItemMap inventoryMap_;
+        InventoryStatus status_ = InventoryStatus::NoSoulGemsOwned;
+        bool isInventoryMapDirty_ = true;
+
+        void refresh_()
+        {
+            if (isInventoryMapDirty_) {
+                reset_();
+            }
+        }
+
+        void reset_();
+        std::optional<SearchResult> findFirstOwnedSoulGem_(
+            SoulGemCapacity capacity,
+            SoulSize containedSoulSize);
+        SoulSize replaceSoulGem_(
+            RE::TESSoulGem* soulGemToAdd,
+            RE::TESSoulGem* soulGemToRemove,
+            RE::InventoryEntryData* soulGemToRemoveEntryData);
+
+    public:
+        explicit Inventory_(
+            RE::Actor* const caster,
+            const ConfigSnapshot& config)
+            : caster_(caster)
+            , config_(config)
+        {}
+
+        InventoryStatus status() override
+        {
+            refresh_();
+            return status_;
+        }
+
+        bool hasSoulGem(
+            const SoulGemCapacity capacity,
+            const SoulSize containedSoulSize) override
+        {
+            return findFirstOwnedSoulGem_(capacity, containedSoulSize)
+                .has_value();
+        }
+
+        std::optional<SoulSize> fillSoulGem(
+            SoulGemCapacity capacity,
+            SoulSize containedSoulSize,
+            SoulSize soulSize) override;
+
+        ShadowTrapRunner::InventorySnapshot countSoulGems() override;
+    };
+
+    void Inventory_::reset_()
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        std::size_t maxFilledSoulGemsCount = 0;
+
+        // This should be a move.
+        inventoryMap_ =
+            getInventoryFor(caster_, [&](const RE::TESBoundObject& obj) {
+                return obj.IsSoulGem();
+            });
+
+        // Counts the number of fully-filled soul gems.
+        //
+        // Note: This ignores the fact that we can still displace white
+        // grand souls from black soul gems and vice versa.
+        //
+        // However, displacing white grand souls from black soul gems only
+        // adds value when there exists a soul gem it can be displaced to,
+        // thus it's preferable that we exit the soul processing anyway.
+        for (const auto& [obj, entryData] : inventoryMap_) {
+            const auto soulGem = obj->As<RE::TESSoulGem>();
+
+            // Can happen if the type-cast failed, but all objects in the map
+            // *should* be soul gems already.
+            assert(soulGem != nullptr);
+
+            if (soulGem->GetMaximumCapacity() == soulGem->GetContainedSoul()) {
+                ++maxFilledSoulGemsCount;
+            }
+        }
+
+        if (inventoryMap_.size() <= 0) {
+            status_ = InventoryStatus::NoSoulGemsOwned;
+        } else if (inventoryMap_.size() == maxFilledSoulGemsCount) {
+            status_ = InventoryStatus::AllSoulGemsFilled;
+        } else {
+            status_ = InventoryStatus::HasSoulGemsToFill;
+        }
+
+        isInventoryMapDirty_ = false;
+
+        Metrics::getInstance().recordInventoryRescan(
+            std::chrono::steady_clock::now() - begin);
+    }
+
+    std::optional<SearchResult> Inventory_::findFirstOwnedSoulGem_(
+        const SoulGemCapacity capacity,
+        const SoulSize containedSoulSize)
+    {
+        refresh_();
+
+        const auto& [begin, end] =
+            YASTMConfig::getInstance().soulGemMap().getSoulGemsWith(
+                capacity,
+                containedSoulSize);
+
+        for (auto it = begin; it != end; ++it) {
+            const auto boundObject = it->As<RE::TESBoundObject>();
+
+            if (inventoryMap_.contains(boundObject)) {
+                if (const auto& data = inventoryMap_.at(boundObject);
+                    data.first > 0) {
+                    return std::make_optional<SearchResult>(
+                        it,
+                        data.first,
+                        data.second.get());
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    SoulSize Inventory_::replaceSoulGem_(
+        RE::TESSoulGem* const soulGemToAdd,
+        RE::TESSoulGem* const soulGemToRemove,
+        RE::InventoryEntryData* const soulGemToRemoveEntryData)
+    {
+        RE::ExtraDataList* oldExtraList = nullptr;
+        std::unique_ptr<RE::ExtraDataList> newExtraList;
+        SoulSize extraSoulSize = SoulSize::None;
+
+        if (config_[BC::AllowExtraSoulRelocation] ||
+            config_[BC::PreserveOwnership]) {
+            oldExtraList = getFirstExtraDataList_(soulGemToRemoveEntryData);
+        }
+
+        if (config_[BC::AllowExtraSoulRelocation] && oldExtraList != nullptr) {
+            const RE::SOUL_LEVEL soulLevel = oldExtraList->GetSoulLevel();
+
+            if (soulLevel != RE::SOUL_LEVEL::kNone) {
+                // Assume that soul gems that can hold black souls and contain a
+                // grand soul are holding a black soul (original information is
+                // long gone anyway).
+                if (soulLevel == RE::SOUL_LEVEL::kGrand &&
+                    canHoldBlackSoul(soulGemToRemove)) {
+                    extraSoulSize = SoulSize::Black;
+                } else {
+                    extraSoulSize = toSoulSize(soulLevel);
+                }
+            }
+        }
+
+        if (config_[BC::PreserveOwnership]) {
+            newExtraList = createExtraDataListFromOriginal(oldExtraList);
+        }
+
+        LOG_CHANNEL_TRACE_FMT(
+            LogChannel::Trap,
+            "Replacing soul gems in {}'s inventory",
+            caster_->GetName());
+        LOG_CHANNEL_TRACE_FMT(
+            LogChannel::Trap,
+            "- from: {:f}",
+            *soulGemToRemove);
+        LOG_CHANNEL_TRACE_FMT(LogChannel::Trap, "- to: {:f}", *soulGemToAdd);
+
+        caster_->AddObjectToContainer(
+            soulGemToAdd,
+            newExtraList.release(), // Transfer ownership to the engine.
+            1,
+            nullptr);
+        caster_->RemoveItem(
+            soulGemToRemove,
+            1,
+            RE::ITEM_REMOVE_REASON::kRemove,
+            oldExtraList,
+            nullptr);
+        isInventoryMapDirty_ = true;
+
+        return extraSoulSize;
+    }
+
+    std::optional<SoulSize> Inventory_::fillSoulGem(
+        const SoulGemCapacity capacity,
+        const SoulSize containedSoulSize,
+        const SoulSize soulSize)
+    {
+        const auto maybeFirstOwned =
+            findFirstOwnedSoulGem_(capacity, containedSoulSize);
+
+        if (!maybeFirstOwned.has_value()) {
+            return std::nullopt;
+        }
+
+        const auto& firstOwned = maybeFirstOwned.value();
+
+        return replaceSoulGem_(
+            firstOwned.soulGemAt(soulSize),
+            firstOwned.soulGem(),
+            firstOwned.entryData());
+    }
+
+    ShadowTrapRunner::InventorySnapshot Inventory_::countSoulGems()
+    {
+        refresh_();
+
+        ShadowTrapRunner::InventorySnapshot result;
+
+        for (const auto& [boundObject, entry] : inventoryMap_) {
+            if (const auto soulGem = boundObject->As<RE::TESSoulGem>();
+                soulGem != nullptr) {
+                result.emplace(soulGem, entry.first);
+            }
+        }
+
+        return result;
+    }
+} // namespace
+
+bool GameSoulTrapBackend::isDead(RE::Actor* const actor)
+{
+    return actor->IsDead(false);
+}
+
+bool GameSoulTrapBackend::isPlayer(RE::Actor* const actor)
+{
+    return actor->IsPlayerRef();
+}
+
+SoulTrapBackend::FormID GameSoulTrapBackend::getFormId(RE::Actor* const actor)
+{
+    return actor->GetFormID();
+}
+
+RE::Actor* GameSoulTrapBackend::lookupActor(const FormID formId)
+{
+    return RE::TESForm::LookupByID<RE::Actor>(formId);
+}
+
+int GameSoulTrapBackend::getSoulTrapLevel(RE::Actor* const caster)
+{
+    using AV = RE::ActorValue;
+
+    const auto conjurationLevel = caster->GetActorValue(AV::kConjuration);
+
+    LOG_CHANNEL_TRACE_FMT(
+        LogChannel::Trap,
+        "Retrieved conjuration skill level: {}",
+        conjurationLevel);
+
+    return static_cast<int>(conjurationLevel);
+}
+
+std::unique_ptr<SoulTrapBackend::Inventory> GameSoulTrapBackend::getInventory(
+    RE::Actor* const caster,
+    const ConfigSnapshot& config)
+{
+    return std::make_unique<Inventory_>(caster, config);
+}
+
+SoulSize GameSoulTrapBackend::getSoulSize(RE::Actor* const victim)
+{
+    return getActorSoulSize(victim);
+}
+
+bool GameSoulTrapBackend::isSoulTrapped(RE::Actor* const victim)
+{
+    return native::getRemainingSoulLevelValue(victim) == SoulLevelValue::None;
+}
+
+void GameSoulTrapBackend::flagSoulTrapped(RE::Actor* const victim)
+{
+    if (RE::AIProcess* const process = victim->currentProcess; process) {
+        if (process->middleHigh) {
+            LOG_CHANNEL_TRACE(
+                LogChannel::Trap,
+                "Flagging soul trapped victim...");
+            process->middleHigh->soulTrapped = true;
+        }
+    }
+}
+
+ConfigSnapshot GameSoulTrapBackend::snapshotConfig(const int soulTrapLevel)
+{
+    return ConfigSnapshot(YASTMConfig::getInstance(), soulTrapLevel);
+}
+
+const SoulTierTable& GameSoulTrapBackend::soulTiers()
+{
+    return YASTMConfig::getInstance().soulTiers();
+}
+
+void GameSoulTrapBackend::notify(const char* const message)
+{
+    RE::DebugNotification(message);
+}
+
+void GameSoulTrapBackend::sendSoulTrapEvent(
+    RE::Actor* const caster,
+    RE::Actor* const victim)
+{
+    RE::SoulsTrapped::SendEvent(caster, victim);
+}
+
+void GameSoulTrapBackend::addTask(std::function<void()> task)
+{
+    SKSE::GetTaskInterface()->AddTask(std::move(task));
+}
+
+std::optional<ShadowTrapRunner::ResolvedStrategy>
+    GameSoulTrapBackend::sampleShadowRun(const ConfigSnapshot& config)
+{
+    auto& runner = ShadowTrapRunner::getInstance();
+
+    if (!runner.shouldSample()) {
+        return std::nullopt;
+    }
+
+    return runner.resolveStrategy(config);
+}
+
+void GameSoulTrapBackend::submitShadowRun(ShadowTrapRunner::Run&& run)
+{
+    ShadowTrapRunner::getInstance().submit(std::move(run));
+}
+
+bool trapSoul(RE::Actor* const caster, RE::Actor* const victim)
+{
+    return trapSoul(caster, victim, GameSoulTrapBackend::getInstance());
+}
+
+RE::Actor* getProxyCaster(RE::Actor* const caster)
+{
+    const auto& config = YASTMConfig::getInstance();
+
+    if (config.getGlobalBool(BoolConfigKey::AllowSoulDiversion) &&
+        caster->IsPlayerTeammate()) {
+        const auto playerActor = RE::PlayerCharacter::GetSingleton();
+
+        if (playerActor != nullptr) {
+            LOG_CHANNEL_TRACE(
+                LogChannel::Trap,
+                "Soul trap diverted to player."sv);
+            return playerActor;
+        } else {
+            LOG_WARN("Failed to find player reference for soul diversion.");
+        }
+    }
+
+    return caster;
+}
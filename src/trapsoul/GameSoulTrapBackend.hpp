@@ -0,0 +1,48 @@
+#pragma once
+
+#include "SoulTrapBackend.hpp"
+
+/**
+ * @brief Performs the soul trap game operations on the actual game objects.
+ */
+class GameSoulTrapBackend : public SoulTrapBackend {
+    explicit GameSoulTrapBackend() = default;
+
+public:
+    GameSoulTrapBackend(const GameSoulTrapBackend&) = delete;
+    GameSoulTrapBackend(GameSoulTrapBackend&&) = delete;
+    GameSoulTrapBackend& operator=(const GameSoulTrapBackend&) = delete;
+    GameSoulTrapBackend& operator=(GameSoulTrapBackend&&) = delete;
+
+    static GameSoulTrapBackend& getInstance()
+    {
+        static GameSoulTrapBackend instance;
+        return instance;
+    }
+
+    bool isDead(RE::Actor* actor) override;
+    bool isPlayer(RE::Actor* actor) override;
+    FormID getFormId(RE::Actor* actor) override;
+    RE::Actor* lookupActor(FormID formId) override;
+
+    int getSoulTrapLevel(RE::Actor* caster) override;
+    std::unique_ptr<Inventory> getInventory(
+        RE::Actor* caster,
+        const ConfigSnapshot& config) override;
+
+    SoulSize getSoulSize(RE::Actor* victim) override;
+    bool isSoulTrapped(RE::Actor* victim) override;
+    void flagSoulTrapped(RE::Actor* victim) override;
+
+    ConfigSnapshot snapshotConfig(int soulTrapLevel) override;
+    const SoulTierTable& soulTiers() override;
+
+    void notify(const char* message) override;
+    void sendSoulTrapEvent(RE::Actor* caster, RE::Actor* victim) override;
+
+    void addTask(std::function<void()> task) override;
+
+    std::optional<ShadowTrapRunner::ResolvedStrategy>
+        sampleShadowRun(const ConfigSnapshot& config) override;
+    void submitShadowRun(ShadowTrapRunner::Run&& run) override;
+};
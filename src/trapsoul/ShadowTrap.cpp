@@ -0,0 +1,434 @@
+#include "ShadowTrap.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "../global.hpp"
+#include "../SoulValue.hpp"
+#include "../config/SoulGemMap.hpp"
+#include "../config/SoulTierTable.hpp"
+#include "../config/YASTMConfig.hpp"
+#include "../utilities/LogChannel.hpp"
+
+namespace {
+    /**
+     * @brief Returns true if a soul gem with the given capacity is full after
+     * being filled with a soul of the given size.
+     */
+    bool isFullAfterFilling_(
+        const SoulGemCapacity capacity,
+        const SoulSize soulSize) noexcept
+    {
+        switch (capacity) {
+        case SoulGemCapacity::Dual:
+            return soulSize >= SoulSize::Grand;
+        case SoulGemCapacity::Black:
+            return soulSize == SoulSize::Black;
+        }
+
+        return soulSize == toSoulSize(capacity);
+    }
+
+    /**
+     * @brief Dry-run counterpart of the soul trap in trapsoul.cpp. Follows the
+     * same search orders, but fills soul gems by updating form counts instead
+     * of modifying the caster's inventory.
+     */
+    class DryRun_ {
+        struct Soul {
+            SoulSize soulSize;
+            bool isSplit;
+
+            friend auto operator<=>(const Soul& lhs, const Soul& rhs) noexcept
+            {
+                return lhs.soulSize <=> rhs.soulSize;
+            }
+        };
+
+        ShadowTrapRunner::InventorySnapshot inventory_;
+        /**
+         * @brief Number of soul gems that can't hold any more souls.
+         */
+        int fullSoulGemCount_ = 0;
+        int soulGemCount_ = 0;
+        InventoryStatus initialInventoryStatus_;
+        std::priority_queue<Soul> souls_;
+
+        const ShadowTrapRunner::ResolvedStrategy& strategy_;
+        const SoulGemMap& soulGemMap_;
+        const SoulTierTable& soulTiers_;
+
+        InventoryStatus inventoryStatus_() const noexcept
+        {
+            // The snapshot can't tell which of the original soul gems are
+            // full, so the status only changes once a soul gem was filled.
+            if (fullSoulGemCount_ == 0) {
+                return initialInventoryStatus_;
+            }
+
+            return fullSoulGemCount_ < soulGemCount_
+                       ? InventoryStatus::HasSoulGemsToFill
+                       : InventoryStatus::AllSoulGemsFilled;
+        }
+
+        bool fill_(
+            const SoulGemCapacity capacity,
+            const SoulSize containedSoulSize,
+            const SoulSize soulSize)
+        {
+            const auto& [begin, end] =
+                soulGemMap_.getSoulGemsWith(capacity, containedSoulSize);
+
+            for (auto it = begin; it != end; ++it) {
+                const auto owned = inventory_.find(it.get());
+
+                if (owned != inventory_.end() && owned->second > 0) {
+                    --owned->second;
+                    ++inventory_[it.group().at(soulSize)];
+
+                    if (isFullAfterFilling_(capacity, soulSize)) {
+                        ++fullSoulGemCount_;
+                    }
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool trapBlackSoul_()
+        {
+            if (fill_(
+                    SoulGemCapacity::Black,
+                    SoulSize::None,
+                    SoulSize::Black)) {
+                return true;
+            }
+
+            const SoulSize maxContainedSoulSizeToSearch =
+                strategy_.allowSoulDisplacement ? SoulSize::Black
+                                                : SoulSize::Petty;
+
+            for (SoulSizeValue containedSoulSize = SoulSize::None;
+                 containedSoulSize < maxContainedSoulSizeToSearch;
+                 ++containedSoulSize) {
+                if (fill_(
+                        SoulGemCapacity::Dual,
+                        containedSoulSize,
+                        SoulSize::Black)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool trapFullSoul_(const SoulSize soulSize)
+        {
+            const SoulGemCapacity maxSoulCapacityToSearch =
+                strategy_.allowPartiallyFillingSoulGems
+                    ? SoulGemCapacity::LastWhite
+                    : toSoulGemCapacity(soulSize);
+            const SoulSize maxContainedSoulSizeToSearch =
+                strategy_.allowSoulDisplacement ? soulSize : SoulSize::Petty;
+
+            const auto& searchOrder = strategy_.allowSoulRelocation
+                                          ? soulTiers_.bestFitOrder(soulSize)
+                                          : soulTiers_.leastDisplacementOrder(
+                                                soulSize);
+
+            for (const auto& [capacity, containedSoulSize] : searchOrder) {
+                if (capacity > maxSoulCapacityToSearch ||
+                    containedSoulSize >= maxContainedSoulSizeToSearch) {
+                    continue;
+                }
+
+                if (fill_(capacity, containedSoulSize, soulSize)) {
+                    return true;
+                }
+            }
+
+            // Moves the black soul out of a dual soul gem first, like
+            // tryReplaceBlackSoulInDualSoulGemWithWhiteSoul_().
+            if (strategy_.allowSoulRelocation &&
+                strategy_.allowSoulDisplacement &&
+                (strategy_.allowPartiallyFillingSoulGems ||
+                 soulSize == SoulSize::Grand)) {
+                const auto& [begin, end] = soulGemMap_.getSoulGemsWith(
+                    SoulGemCapacity::Dual,
+                    SoulSize::Black);
+                const bool hasBlackFilledDualSoulGem =
+                    std::any_of(begin, end, [this](auto& soulGem) {
+                        const auto owned = inventory_.find(&soulGem);
+                        return owned != inventory_.end() && owned->second > 0;
+                    });
+
+                if (hasBlackFilledDualSoulGem &&
+                    fill_(
+                        SoulGemCapacity::Black,
+                        SoulSize::None,
+                        SoulSize::Black)) {
+                    return fill_(
+                        SoulGemCapacity::Dual,
+                        SoulSize::Black,
+                        soulSize);
+                }
+            }
+
+            return false;
+        }
+
+        bool trapShrunkSoul_(const SoulSize soulSize)
+        {
+            for (SoulGemCapacityValue capacity =
+                     toSoulGemCapacity(soulSize) - 1;
+                 capacity >= SoulGemCapacity::First;
+                 --capacity) {
+                const SoulSize maxContainedSoulSizeToSearch =
+                    strategy_.allowSoulDisplacement ? toSoulSize(capacity)
+                                                    : SoulSize::Petty;
+
+                for (SoulSizeValue containedSoulSize = SoulSize::None;
+                     containedSoulSize < maxContainedSoulSizeToSearch;
+                     ++containedSoulSize) {
+                    if (fill_(
+                            capacity,
+                            containedSoulSize,
+                            toSoulSize(capacity))) {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        bool trapSplitSoul_(const SoulSize soulSize)
+        {
+            const SoulSize maxContainedSoulSizeToSearch =
+                strategy_.allowSoulDisplacement ? soulSize : SoulSize::Petty;
+
+            for (SoulSizeValue containedSoulSize = SoulSize::None;
+                 containedSoulSize < maxContainedSoulSizeToSearch;
+                 ++containedSoulSize) {
+                if (fill_(
+                        toSoulGemCapacity(soulSize),
+                        containedSoulSize,
+                        soulSize)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void splitSoul_(const SoulSize soulSize)
+        {
+            if (soulSize == SoulSize::Black) {
+                return;
+            }
+
+            if (const auto& split = soulTiers_.split(soulSize);
+                split.isSplittable()) {
+                souls_.push({split.first, true});
+                souls_.push({split.second, true});
+            }
+        }
+
+    public:
+        explicit DryRun_(
+            const ShadowTrapRunner::Run& run,
+            const SoulGemMap& soulGemMap,
+            const SoulTierTable& soulTiers)
+            : inventory_(run.inventory)
+            , initialInventoryStatus_(run.inventoryStatus)
+            , strategy_(run.strategy)
+            , soulGemMap_(soulGemMap)
+            , soulTiers_(soulTiers)
+        {
+            for (const auto& [soulGem, count] : inventory_) {
+                soulGemCount_ += count;
+            }
+
+            souls_.push({run.soulSize, false});
+        }
+
+        TrapOutcome run()
+        {
+            using SST = SoulShrinkingTechnique;
+
+            bool isSoulTrapSuccessful = false;
+
+            while (!souls_.empty()) {
+                const auto soul = souls_.top();
+                souls_.pop();
+
+                if (inventoryStatus_() != InventoryStatus::HasSoulGemsToFill) {
+                    break;
+                }
+
+                if (soul.soulSize == SoulSize::Black) {
+                    isSoulTrapSuccessful |= trapBlackSoul_();
+                } else if (soul.isSplit) {
+                    if (trapSplitSoul_(soul.soulSize)) {
+                        isSoulTrapSuccessful = true;
+                    } else {
+                        splitSoul_(soul.soulSize);
+                    }
+                } else if (trapFullSoul_(soul.soulSize)) {
+                    isSoulTrapSuccessful = true;
+                } else if (strategy_.soulShrinkingTechnique == SST::Shrink) {
+                    isSoulTrapSuccessful |= trapShrunkSoul_(soul.soulSize);
+                } else if (strategy_.soulShrinkingTechnique == SST::Split) {
+                    splitSoul_(soul.soulSize);
+                }
+            }
+
+            if (isSoulTrapSuccessful) {
+                return TrapOutcome::Success;
+            }
+
+            switch (inventoryStatus_()) {
+            case InventoryStatus::AllSoulGemsFilled:
+                return TrapOutcome::AllSoulGemsFilled;
+            case InventoryStatus::NoSoulGemsOwned:
+                return TrapOutcome::NoSoulGemsOwned;
+            }
+
+            return strategy_.soulShrinkingTechnique != SST::None
+                       ? TrapOutcome::NoSuitableSoulGem
+                       : TrapOutcome::NoSoulGemLargeEnough;
+        }
+    };
+} // namespace
+
+void ShadowTrapRunner::run_(
+    const std::stop_token stopToken,
+    ShadowTrapRunner& runner)
+{
+    std::unique_lock lock(runner.mutex_);
+
+    while (true) {
+        runner.wakeUp_.wait(lock, stopToken, [&runner] {
+            return !runner.pendingRuns_.empty();
+        });
+
+        if (stopToken.stop_requested()) {
+            break;
+        }
+
+        const auto run = std::move(runner.pendingRuns_.front());
+        runner.pendingRuns_.pop_front();
+
+        lock.unlock();
+
+        try {
+            const auto begin = clock_type::now();
+            const auto outcome = simulate(run);
+            const auto simulationDuration = clock_type::now() - begin;
+
+            Metrics::getInstance().recordShadowRun(
+                run.productionOutcome,
+                outcome,
+                run.productionPlacementDuration,
+                simulationDuration);
+
+            if (outcome != run.productionOutcome) {
+                LOG_CHANNEL_DEBUG_FMT(
+                    LogChannel::Trap,
+                    "Shadow soul trap diverged for {:t} soul: production={}, "
+                    "shadow={}",
+                    run.soulSize,
+                    toString(run.productionOutcome),
+                    toString(outcome));
+            }
+        } catch (const std::exception& error) {
+            LOG_CHANNEL_WARN_LIMITED_FMT(
+                LogChannel::Trap,
+                "Shadow soul trap failed: {}",
+                error.what());
+        }
+
+        lock.lock();
+    }
+}
+
+void ShadowTrapRunner::start(
+    const ShadowStrategy& strategy,
+    const std::uint64_t sampleEvery,
+    const std::size_t maxPendingRuns)
+{
+    stop();
+
+    LOG_INFO_FMT(
+        "Shadow mode enabled: sampling 1 in {} soul trap(s), up to {} pending.",
+        sampleEvery,
+        maxPendingRuns);
+
+    {
+        std::unique_lock lock(mutex_);
+
+        strategy_ = strategy;
+        sampleEvery_ = sampleEvery;
+        maxPendingRuns_ = maxPendingRuns;
+    }
+
+    thread_ = std::jthread(&ShadowTrapRunner::run_, std::ref(*this));
+    isRunning_.store(true, std::memory_order_release);
+}
+
+void ShadowTrapRunner::stop()
+{
+    isRunning_.store(false, std::memory_order_release);
+
+    if (thread_.joinable()) {
+        thread_.request_stop();
+        thread_.join();
+    }
+
+    std::unique_lock lock(mutex_);
+    pendingRuns_.clear();
+}
+
+ShadowTrapRunner::ResolvedStrategy
+    ShadowTrapRunner::resolveStrategy(const ConfigSnapshot& config) const
+{
+    return ResolvedStrategy{
+        .soulShrinkingTechnique = strategy_.soulShrinkingTechnique.value_or(
+            config.get<EnumConfigKey::SoulShrinkingTechnique>()),
+        .allowPartiallyFillingSoulGems =
+            strategy_.allowPartiallyFillingSoulGems.value_or(
+                config[BoolConfigKey::AllowPartiallyFillingSoulGems]),
+        .allowSoulDisplacement = strategy_.allowSoulDisplacement.value_or(
+            config[BoolConfigKey::AllowSoulDisplacement]),
+        .allowSoulRelocation = strategy_.allowSoulRelocation.value_or(
+            config[BoolConfigKey::AllowSoulRelocation]),
+    };
+}
+
+void ShadowTrapRunner::submit(Run&& run)
+{
+    {
+        std::unique_lock lock(mutex_);
+
+        if (pendingRuns_.size() >= maxPendingRuns_) {
+            lock.unlock();
+            Metrics::getInstance().recordShadowRunDropped();
+            return;
+        }
+
+        pendingRuns_.push_back(std::move(run));
+    }
+
+    wakeUp_.notify_one();
+}
+
+TrapOutcome ShadowTrapRunner::simulate(const Run& run)
+{
+    const auto& config = YASTMConfig::getInstance();
+
+    return DryRun_(run, config.soulGemMap(), config.soulTiers()).run();
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+#include "InventoryStatus.hpp"
+#include "../SoulSize.hpp"
+#include "../config/ConfigSnapshot.hpp"
+#include "../config/ConfigKey/EnumConfigKey.hpp"
+#include "../utilities/Metrics.hpp"
+
+namespace RE {
+    class TESSoulGem;
+} // namespace RE
+
+/**
+ * @brief Alternative soul trap settings to dry-run in shadow mode. Unset
+ * options use the production value at the time of the soul trap.
+ */
+struct ShadowStrategy {
+    std::optional<SoulShrinkingTechnique> soulShrinkingTechnique;
+    std::optional<bool> allowPartiallyFillingSoulGems;
+    std::optional<bool> allowSoulDisplacement;
+    std::optional<bool> allowSoulRelocation;
+};
+
+/**
+ * @brief Dry-runs an alternative soul trap strategy on a background thread and
+ * records where its outcome and timing diverge from the real soul trap.
+ *
+ * Only one in every N soul traps is sampled, and at most a fixed number of
+ * runs can be pending at once. Runs submitted while the queue is full are
+ * dropped (and counted) instead of blocking the soul trap.
+ *
+ * Dry runs work on a copy of the caster's soul gem counts taken before the
+ * real soul trap modifies the inventory, and never touch game objects. Only
+ * the placement of the primary soul is simulated since displaced souls don't
+ * affect the outcome.
+ *
+ * The time taken by the real placement and by the dry run are recorded as
+ * separate series and can't be compared: the real placement includes scanning
+ * and changing the caster's inventory, while the dry run only updates counts
+ * in memory.
+ */
+class ShadowTrapRunner {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * @brief Number of each soul gem form owned by the caster.
+     */
+    using InventorySnapshot = std::unordered_map<RE::TESSoulGem*, int>;
+
+    struct ResolvedStrategy {
+        SoulShrinkingTechnique soulShrinkingTechnique;
+        bool allowPartiallyFillingSoulGems;
+        bool allowSoulDisplacement;
+        bool allowSoulRelocation;
+    };
+
+    struct Run {
+        InventorySnapshot inventory;
+        InventoryStatus inventoryStatus;
+        SoulSize soulSize;
+        ResolvedStrategy strategy;
+        TrapOutcome productionOutcome;
+        /**
+         * @brief Time taken by the real soul trap to place the primary soul,
+         * including inventory scans and changes.
+         */
+        clock_type::duration productionPlacementDuration;
+    };
+
+private:
+    std::jthread thread_;
+    std::mutex mutex_;
+    std::condition_variable_any wakeUp_;
+    std::deque<Run> pendingRuns_;
+
+    ShadowStrategy strategy_;
+    std::uint64_t sampleEvery_ = 1;
+    std::size_t maxPendingRuns_ = 0;
+    std::atomic<std::uint64_t> trapCount_ = 0;
+    std::atomic<bool> isRunning_ = false;
+
+    explicit ShadowTrapRunner() = default;
+
+    static void run_(std::stop_token stopToken, ShadowTrapRunner& runner);
+
+public:
+    ShadowTrapRunner(const ShadowTrapRunner&) = delete;
+    ShadowTrapRunner(ShadowTrapRunner&&) = delete;
+    ShadowTrapRunner& operator=(const ShadowTrapRunner&) = delete;
+    ShadowTrapRunner& operator=(ShadowTrapRunner&&) = delete;
+
+    ~ShadowTrapRunner() { stop(); }
+
+    static ShadowTrapRunner& getInstance()
+    {
+        static ShadowTrapRunner instance;
+        return instance;
+    }
+
+    /**
+     * @brief Starts shadow mode. Restarts it if it is already running.
+     */
+    void start(
+        const ShadowStrategy& strategy,
+        std::uint64_t sampleEvery,
+        std::size_t maxPendingRuns);
+
+    /**
+     * @brief Stops shadow mode and drops pending runs. Does nothing if shadow
+     * mode isn't running.
+     */
+    void stop();
+
+    /**
+     * @brief Returns true if the current soul trap should be dry-run. Call once
+     * per soul trap.
+     */
+    bool shouldSample() noexcept
+    {
+        if (!isRunning_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        return trapCount_.fetch_add(1, std::memory_order_relaxed) %
+                   sampleEvery_ ==
+               0;
+    }
+
+    /**
+     * @brief Fills in the options the shadow strategy doesn't override with
+     * the production values.
+     */
+    ResolvedStrategy resolveStrategy(const ConfigSnapshot& config) const;
+
+    /**
+     * @brief Queues a dry run. Drops it if too many runs are pending.
+     */
+    void submit(Run&& run);
+
+    /**
+     * @brief Simulates the soul trap for the given run and returns its
+     * outcome.
+     */
+    static TrapOutcome simulate(const Run& run);
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "InventoryStatus.hpp"
+#include "ShadowTrap.hpp"
+#include "../SoulSize.hpp"
+#include "../config/ConfigSnapshot.hpp"
+
+namespace RE {
+    class Actor;
+} // namespace RE
+
+class SoulTierTable;
+
+/**
+ * @brief The game operations the soul trap in trapsoul.cpp depends on.
+ *
+ * GameSoulTrapBackend implements these for the game. The soul trap logic only
+ * goes through this interface, so it can also be built and tested on the host
+ * with a fake backend.
+ *
+ * Apart from addTask(), all calls for a soul trap are made with the soul trap
+ * lock held, so implementations don't need their own locking for the caster
+ * and victim state.
+ */
+class SoulTrapBackend {
+public:
+    using FormID = std::uint32_t;
+
+    /**
+     * @brief The soul gems in a caster's inventory.
+     *
+     * Implementations may work on a scan of the inventory. If so, each call
+     * rescans the inventory first if a soul gem was filled since the last scan.
+     */
+    class Inventory {
+    public:
+        virtual ~Inventory() {}
+
+        virtual InventoryStatus status() = 0;
+
+        /**
+         * @brief Returns true if the caster owns a soul gem with the given
+         * capacity and contained soul size.
+         */
+        virtual bool hasSoulGem(
+            SoulGemCapacity capacity,
+            SoulSize containedSoulSize) = 0;
+
+        /**
+         * @brief Replaces an owned soul gem with the given capacity and
+         * contained soul size with one holding a soul of the given size.
+         *
+         * @returns std::nullopt if the caster owns no such soul gem. Otherwise,
+         * the size of an extra soul stored in the replaced soul gem that should
+         * be relocated, or SoulSize::None if there is none or extra soul
+         * relocation is disabled.
+         */
+        virtual std::optional<SoulSize> fillSoulGem(
+            SoulGemCapacity capacity,
+            SoulSize containedSoulSize,
+            SoulSize soulSize) = 0;
+
+        /**
+         * @brief Returns the number of each soul gem form owned, for shadow
+         * mode dry runs.
+         */
+        virtual ShadowTrapRunner::InventorySnapshot countSoulGems() = 0;
+    };
+
+    virtual ~SoulTrapBackend() {}
+
+    virtual bool isDead(RE::Actor* actor) = 0;
+    virtual bool isPlayer(RE::Actor* actor) = 0;
+    virtual FormID getFormId(RE::Actor* actor) = 0;
+    /**
+     * @brief Returns the actor with the given form ID, or nullptr if there is
+     * none.
+     */
+    virtual RE::Actor* lookupActor(FormID formId) = 0;
+
+    /**
+     * @brief Returns the "level" of the soul trap for the caster. This is
+     * currently based on the caster's conjuration skill level.
+     */
+    virtual int getSoulTrapLevel(RE::Actor* caster) = 0;
+    /**
+     * @brief Returns the caster's soul gems. Soul gems are replaced according
+     * to the given configuration.
+     */
+    virtual std::unique_ptr<Inventory> getInventory(
+        RE::Actor* caster,
+        const ConfigSnapshot& config) = 0;
+
+    virtual SoulSize getSoulSize(RE::Actor* victim) = 0;
+    /**
+     * @brief Returns true if the victim's soul has already been trapped.
+     */
+    virtual bool isSoulTrapped(RE::Actor* victim) = 0;
+    virtual void flagSoulTrapped(RE::Actor* victim) = 0;
+
+    /**
+     * @brief Returns a snapshot of the configuration for a caster with the
+     * given soul trap level.
+     */
+    virtual ConfigSnapshot snapshotConfig(int soulTrapLevel) = 0;
+    virtual const SoulTierTable& soulTiers() = 0;
+
+    virtual void notify(const char* message) = 0;
+    virtual void sendSoulTrapEvent(RE::Actor* caster, RE::Actor* victim) = 0;
+
+    /**
+     * @brief Runs the task later on the main thread. May be called from any
+     * thread.
+     */
+    virtual void addTask(std::function<void()> task) = 0;
+
+    /**
+     * @brief Returns the strategy to dry-run the current soul trap with in
+     * shadow mode, or std::nullopt if it isn't sampled. Call once per soul
+     * trap.
+     */
+    virtual std::optional<ShadowTrapRunner::ResolvedStrategy>
+        sampleShadowRun(const ConfigSnapshot& config) = 0;
+    virtual void submitShadowRun(ShadowTrapRunner::Run&& run) = 0;
+};
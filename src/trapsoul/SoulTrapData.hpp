@@ -1,36 +1,29 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 
-#include <RE/A/Actor.h>
-#include <RE/M/Misc.h>
-#include <RE/P/PlayerCharacter.h>
-#include <RE/S/SoulsTrapped.h>
-#include <RE/T/TESForm.h>
-#include <RE/T/TESBoundObject.h>
-
 #include "types.hpp"
 #include "InventoryStatus.hpp"
+#include "SoulTrapBackend.hpp"
 #include "Victim.hpp"
-#include "../global.hpp"
 #include "../messages.hpp"
-#include "../config/YASTMConfig.hpp"
-#include "../utilities/misc.hpp"
+#include "../config/ConfigSnapshot.hpp"
+
+namespace RE {
+    class Actor;
+} // namespace RE
 
 /**
  * @brief Stores and bookkeeps the data for various soul trap variables so
  * we don't end up with functions needing half a dozen arguments.
  */
 class SoulTrapData {
-public:
-    using InventoryItemMap = UnorderedInventoryItemMap;
-
-private:
     static const std::size_t MAX_NOTIFICATION_COUNT = 1;
     std::size_t notifyCount_ = 0;
     bool isSoulTrapEventSent_ = false;
-    bool isInventoryMapDirty_ = true;
 
+    SoulTrapBackend& backend_;
     RE::Actor* caster_;
     // [DEVNOTE] Make sure this variable appears before the config variable
     //           since the value is passed to the snapshot's constructor.
@@ -42,8 +35,7 @@ private:
      */
     int soulTrapLevel_;
     SoulSize maxTrappableSoulSize_;
-    InventoryStatus casterInventoryStatus_;
-    UnorderedInventoryItemMap inventoryMap_;
+    std::unique_ptr<SoulTrapBackend::Inventory> inventory_;
 
     VictimsQueue victims_;
     std::optional<Victim> victim_;
@@ -52,20 +44,19 @@ private:
     template <typename MessageKey>
     void notify_(MessageKey message);
     void sendSoulTrapEvent_(RE::Actor* victim);
-    void resetInventoryData_();
 
 public:
-    const YASTMConfig::Snapshot config;
-    SoulTrapData(RE::Actor* caster);
+    const ConfigSnapshot config;
+    SoulTrapData(SoulTrapBackend& backend, RE::Actor* caster);
 
     SoulTrapData(const SoulTrapData&) = delete;
     SoulTrapData(SoulTrapData&&) = delete;
     SoulTrapData& operator=(const SoulTrapData&) = delete;
     SoulTrapData& operator=(SoulTrapData&&) = delete;
 
-    void setInventoryHasChanged() noexcept { isInventoryMapDirty_ = true; }
     void updateLoopVariables();
 
+    SoulTrapBackend& backend() const noexcept { return backend_; }
     RE::Actor* caster() const noexcept { return caster_; }
     int soulTrapLevel() const noexcept { return soulTrapLevel_; }
     SoulSize maxTrappableSoulSize() const noexcept
@@ -73,8 +64,8 @@ public:
         return maxTrappableSoulSize_;
     }
     int getThresholdForSoulSize(SoulSize soulSize) const;
-    InventoryStatus casterInventoryStatus() const;
-    const InventoryItemMap& inventoryMap() const;
+    InventoryStatus casterInventoryStatus() { return inventory_->status(); }
+    SoulTrapBackend::Inventory& inventory() noexcept { return *inventory_; }
 
     VictimsQueue& victims() noexcept { return victims_; }
     const VictimsQueue& victims() const noexcept { return victims_; }
@@ -98,7 +89,7 @@ inline void SoulTrapData::notify_(const MessageKey message)
 {
     if (notifyCount_ < MAX_NOTIFICATION_COUNT &&
         config[BC::AllowNotifications]) {
-        RE::DebugNotification(getMessage(message));
+        backend_.notify(getMessage(message));
         ++notifyCount_;
     }
 }
@@ -109,7 +100,7 @@ inline void SoulTrapData::notify_<SoulTrapSuccessMessage>(
 {
     if (notifyCount_ < MAX_NOTIFICATION_COUNT &&
         config[BC::AllowNotifications]) {
-        RE::DebugNotification(getMessage(message, isDegradedSoulTrap()));
+        backend_.notify(getMessage(message, isDegradedSoulTrap()));
         ++notifyCount_;
     }
 }
@@ -117,7 +108,7 @@ inline void SoulTrapData::notify_<SoulTrapSuccessMessage>(
 inline void SoulTrapData::sendSoulTrapEvent_(RE::Actor* const victim)
 {
     if (!isSoulTrapEventSent_) {
-        RE::SoulsTrapped::SendEvent(caster(), victim);
+        backend_.sendSoulTrapEvent(caster(), victim);
         isSoulTrapEventSent_ = true;
     }
 }
@@ -126,10 +117,6 @@ inline void SoulTrapData::updateLoopVariables()
 {
     victim_.emplace(victims_.top());
     victims_.pop();
-
-    if (isInventoryMapDirty_) {
-        resetInventoryData_();
-    }
 }
 
 inline int SoulTrapData::getThresholdForSoulSize(const SoulSize soulSize) const
@@ -149,31 +136,17 @@ inline int SoulTrapData::getThresholdForSoulSize(const SoulSize soulSize) const
         return config[IC::SoulTrapThresholdLesser];
     case SoulSize::Petty:
         return config[IC::SoulTrapThresholdPetty];
+    default:
+        break;
     }
 
     return 1;
 }
 
-inline InventoryStatus SoulTrapData::casterInventoryStatus() const
-{
-    // This should not happen if the class is used correctly (the class does
-    // not manage these resources on its own for performance).
-    assert(!isInventoryMapDirty_);
-    return casterInventoryStatus_;
-}
-
-inline const SoulTrapData::InventoryItemMap& SoulTrapData::inventoryMap() const
-{
-    // This should not happen if the class is used correctly (the class does
-    // not manage these resources on its own for performance).
-    assert(!isInventoryMapDirty_);
-    return inventoryMap_;
-}
-
 inline void
     SoulTrapData::notifySoulTrapFailure(const SoulTrapFailureMessage message)
 {
-    if (caster_->IsPlayerRef()) {
+    if (backend_.isPlayer(caster_)) {
         notify_(message);
     }
 }
@@ -182,7 +155,7 @@ inline void SoulTrapData::notifySoulTrapSuccess(
     const SoulTrapSuccessMessage message,
     const Victim& victim)
 {
-    if (caster_->IsPlayerRef() && victim.isPrimarySoul()) {
+    if (backend_.isPlayer(caster_) && victim.isPrimarySoul()) {
         notify_(message);
         sendSoulTrapEvent_(victim.actor());
     }
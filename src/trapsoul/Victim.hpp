@@ -10,8 +10,6 @@
 #include <RE/A/Actor.h>
 
 #include "../SoulSize.hpp"
-#include "../utilities/misc.hpp"
-#include "../utilities/native.hpp"
 
 class Victim {
     RE::Actor* actor_;
@@ -19,16 +17,6 @@ class Victim {
     bool isSplit_;
 
 public:
-    /**
-     * @brief Constructs a primary victim. The soul size calculated from the
-     * actor's properties and the maximum soul size.
-     */
-    explicit Victim(RE::Actor* actor)
-        : actor_(actor)
-        , soulSize_(getActorSoulSize(actor))
-        , isSplit_(false)
-    {}
-
     /**
      * @brief Constructs a victim with no associated actor. This constructor is
      * used for displaced souls.
@@ -1,224 +1,96 @@
 #include "trapsoul.hpp"
 
-#include <deque>
+#include <chrono>
 #include <mutex>
 #include <optional>
-#include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include <cassert>
 
-#include <fmt/format.h>
-
-#include <RE/A/Actor.h>
-#include <RE/S/SoulsTrapped.h>
-#include <RE/T/TESBoundObject.h>
-#include <RE/T/TESObjectREFR.h>
-#include <RE/T/TESSoulGem.h>
-
 #include "../global.hpp"
 #include "../messages.hpp"
 #include "../SoulValue.hpp"
 #include "types.hpp"
 #include "InventoryStatus.hpp"
-#include "SearchResult.hpp"
+#include "ShadowTrap.hpp"
 #include "SoulTrapData.hpp"
 #include "Victim.hpp"
-#include "../config/YASTMConfig.hpp"
-#include "../formatters/TESSoulGem.hpp"
-#include "../utilities/misc.hpp"
-#include "../utilities/native.hpp"
+#include "../config/SoulTierTable.hpp"
+#include "../utilities/Metrics.hpp"
 #include "../utilities/printerror.hpp"
 #include "../utilities/rng.hpp"
-#include "../utilities/Timer.hpp"
 
 using namespace std::literals;
 
 namespace {
-    std::optional<SearchResult> findFirstOwnedObjectInList_(
-        const SoulTrapData::InventoryItemMap& inventoryMap,
-        const SoulGemMap::IteratorPair& objectsToSearch)
-    {
-        const auto& [begin, end] = objectsToSearch;
-
-        for (auto it = begin; it != end; ++it) {
-            const auto boundObject = it->As<RE::TESBoundObject>();
-
-            if (inventoryMap.contains(boundObject)) {
-                if (const auto& data = inventoryMap.at(boundObject);
-                    data.first > 0) {
-                    return std::make_optional<SearchResult>(
-                        it,
-                        data.first,
-                        data.second.get());
-                }
-            }
-        }
-
-        return std::nullopt;
-    }
-
-    [[nodiscard]] RE::ExtraDataList*
-        getFirstExtraDataList_(RE::InventoryEntryData* const entryData)
-    {
-        const auto extraLists = entryData->extraLists;
-
-        if (extraLists == nullptr || extraLists->empty()) {
-            return nullptr;
-        }
-
-        return extraLists->front();
-    }
-
-    void replaceSoulGem_(
-        RE::TESSoulGem* const soulGemToAdd,
-        RE::TESSoulGem* const soulGemToRemove,
-        RE::InventoryEntryData* const soulGemToRemoveEntryData,
-        SoulTrapData& d)
-    {
-        RE::ExtraDataList* oldExtraList = nullptr;
-        std::unique_ptr<RE::ExtraDataList> newExtraList;
-
-        if (d.config[BC::AllowExtraSoulRelocation] ||
-            d.config[BC::PreserveOwnership]) {
-            oldExtraList = getFirstExtraDataList_(soulGemToRemoveEntryData);
-        }
-
-        if (d.config[BC::AllowExtraSoulRelocation] && oldExtraList != nullptr) {
-            const RE::SOUL_LEVEL soulLevel = oldExtraList->GetSoulLevel();
-
-            if (soulLevel != RE::SOUL_LEVEL::kNone) {
-                SoulSize soulSize;
-
-                // Assume that soul gems that can hold black souls and contain a
-                // grand soul are holding a black soul (original information is
-                // long gone anyway).
-                if (soulLevel == RE::SOUL_LEVEL::kGrand &&
-                    canHoldBlackSoul(soulGemToRemove)) {
-                    soulSize = SoulSize::Black;
-                } else {
-                    soulSize = toSoulSize(soulLevel);
-                }
-
-                // Add the extra soul into the queue.
-                LOG_TRACE_FMT("Relocating extra soul of size: {:t}", soulSize);
-                d.victims().emplace(soulSize);
-            }
-        }
-
-        if (d.config[BC::PreserveOwnership]) {
-            newExtraList = createExtraDataListFromOriginal(oldExtraList);
-        }
-
-        LOG_TRACE_FMT(
-            "Replacing soul gems in {}'s inventory",
-            d.caster()->GetName());
-        LOG_TRACE_FMT("- from: {:f}", *soulGemToRemove);
-        LOG_TRACE_FMT("- to: {:f}", *soulGemToAdd);
-
-        d.caster()->AddObjectToContainer(
-            soulGemToAdd,
-            newExtraList.release(), // Transfer ownership to the engine.
-            1,
-            nullptr);
-        d.caster()->RemoveItem(
-            soulGemToRemove,
-            1,
-            RE::ITEM_REMOVE_REASON::kRemove,
-            oldExtraList,
-            nullptr);
-        d.setInventoryHasChanged();
-    }
-
+    /**
+     * @brief Fills one of the caster's soul gems with the given capacity and
+     * contained soul size with a soul of the given size.
+     *
+     * @returns true if the caster owns such a soul gem.
+     */
     bool fillSoulGem_(
-        const SoulGemMap::IteratorPair& sourceSoulGems,
-        const SoulSize targetContainedSoulSize,
-        SoulTrapData& d)
-    {
-        const auto maybeFirstOwned =
-            findFirstOwnedObjectInList_(d.inventoryMap(), sourceSoulGems);
-
-        if (maybeFirstOwned.has_value()) {
-            const auto& firstOwned = maybeFirstOwned.value();
-
-            const auto soulGemToAdd =
-                firstOwned.soulGemAt(targetContainedSoulSize);
-            const auto soulGemToRemove = firstOwned.soulGem();
-
-            replaceSoulGem_(
-                soulGemToAdd,
-                soulGemToRemove,
-                firstOwned.entryData(),
-                d);
-
-            return true;
-        }
-
-        return false;
-    }
-
-    bool fillWhiteSoulGem_(
         const SoulGemCapacity capacity,
         const SoulSize sourceContainedSoulSize,
         const SoulSize targetContainedSoulSize,
         SoulTrapData& d)
     {
-        const auto& soulGemMap = YASTMConfig::getInstance().soulGemMap();
+        const auto extraSoulSize = d.inventory().fillSoulGem(
+            capacity,
+            sourceContainedSoulSize,
+            targetContainedSoulSize);
+
+        if (!extraSoulSize.has_value()) {
+            return false;
+        }
 
-        const auto& sourceSoulGems =
-            soulGemMap.getSoulGemsWith(capacity, sourceContainedSoulSize);
+        if (extraSoulSize.value() != SoulSize::None) {
+            // Add the extra soul into the queue.
+            LOG_CHANNEL_TRACE_FMT(
+                LogChannel::Trap,
+                "Relocating extra soul of size: {:t}",
+                extraSoulSize.value());
+            d.victims().emplace(extraSoulSize.value());
+        }
 
-        return fillSoulGem_(sourceSoulGems, targetContainedSoulSize, d);
+        return true;
     }
 
     bool fillBlackSoulGem_(SoulTrapData& d)
     {
-        const auto& soulGemMap = YASTMConfig::getInstance().soulGemMap();
-        const auto& sourceSoulGems =
-            soulGemMap.getSoulGemsWith(SoulGemCapacity::Black, SoulSize::None);
-
-        return fillSoulGem_(sourceSoulGems, SoulSize::Black, d);
+        return fillSoulGem_(
+            SoulGemCapacity::Black,
+            SoulSize::None,
+            SoulSize::Black,
+            d);
     }
 
     bool tryReplaceBlackSoulInDualSoulGemWithWhiteSoul_(SoulTrapData& d)
     {
-        const auto& soulGemMap = YASTMConfig::getInstance().soulGemMap();
-
-        // Find our black-filled dual soul gem.
-        const auto& sourceSoulGems =
-            soulGemMap.getSoulGemsWith(SoulGemCapacity::Dual, SoulSize::Black);
-
-        const auto maybeFirstOwned =
-            findFirstOwnedObjectInList_(d.inventoryMap(), sourceSoulGems);
-
-        // If the black-filled dual soul exists in the inventory and we can fill
-        // an empty pure black soul gem, fill the dual soul gem with our white
-        // soul.
-        if (maybeFirstOwned.has_value() && fillBlackSoulGem_(d)) {
-            const auto& firstOwned = maybeFirstOwned.value();
-
-            const auto soulGemToAdd =
-                firstOwned.soulGemAt(d.victim().soulSize());
-            const auto soulGemToRemove = firstOwned.soulGem();
-
-            replaceSoulGem_(
-                soulGemToAdd,
-                soulGemToRemove,
-                firstOwned.entryData(),
-                d);
-
-            return true;
-        }
-
-        return false;
+        // If a black-filled dual soul gem exists in the inventory and we can
+        // fill an empty pure black soul gem, fill the dual soul gem with our
+        // white soul.
+        return d.inventory().hasSoulGem(
+                   SoulGemCapacity::Dual,
+                   SoulSize::Black) &&
+               fillBlackSoulGem_(d) &&
+               fillSoulGem_(
+                   SoulGemCapacity::Dual,
+                   SoulSize::Black,
+                   d.victim().soulSize(),
+                   d);
     }
 
     bool trapBlackSoul_(SoulTrapData& d)
     {
-        LOG_TRACE("Trapping black soul...");
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Trapping black soul...");
 
         // We try to trap black souls into black soul gems first. If that
         // succeeds, we can stop here.
-        LOG_TRACE("Looking up pure empty black soul gems");
+        LOG_CHANNEL_TRACE(
+            LogChannel::Trap,
+            "Looking up pure empty black soul gems");
         const bool isSoulTrapped = fillBlackSoulGem_(d);
 
         if (isSoulTrapped) {
@@ -229,8 +101,6 @@ namespace {
             return true;
         }
 
-        const auto& soulGemMap = YASTMConfig::getInstance().soulGemMap();
-
         // When displacement is allowed, we search dual soul gems with a
         // contained soul size up to SoulSize::Grand to allow displacing white
         // grand souls.
@@ -248,16 +118,16 @@ namespace {
         for (SoulSizeValue containedSoulSize = SoulSize::None;
              containedSoulSize < maxContainedSoulSizeToSearch;
              ++containedSoulSize) {
-            LOG_TRACE_FMT(
+            LOG_CHANNEL_TRACE_FMT(
+                LogChannel::Trap,
                 "Looking up dual soul gems with containedSoulSize = {:t}",
                 containedSoulSize);
 
-            const auto& sourceSoulGems = soulGemMap.getSoulGemsWith(
+            const bool result = fillSoulGem_(
                 SoulGemCapacity::Dual,
-                containedSoulSize);
-
-            const bool result =
-                fillSoulGem_(sourceSoulGems, d.victim().soulSize(), d);
+                containedSoulSize,
+                d.victim().soulSize(),
+                d);
 
             if (result) {
                 if (d.config[BC::AllowSoulRelocation] &&
@@ -282,9 +152,9 @@ namespace {
 
     bool trapFullSoul_(SoulTrapData& d)
     {
-        LOG_TRACE("Trapping full white soul...");
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Trapping full white soul...");
 
-        const auto& soulGemMap = YASTMConfig::getInstance().soulGemMap();
+        const auto& soulTiers = d.backend().soulTiers();
 
         // When partial trapping is allowed, we search all soul sizes up to
         // Grand. If it's not allowed, we only look at soul gems with the same
@@ -335,42 +205,43 @@ namespace {
             //             Return
             //         Else
             //             Continue searching
-            for (SoulGemCapacityValue capacity =
-                     toSoulGemCapacity(d.victim().soulSize());
-                 capacity <= maxSoulCapacityToSearch;
-                 ++capacity) {
-                for (SoulSizeValue containedSoulSize = SoulSize::None;
-                     containedSoulSize < maxContainedSoulSizeToSearch;
-                     ++containedSoulSize) {
-                    LOG_TRACE_FMT(
-                        "Looking up white soul gems with capacity = {:t}, "
-                        "containedSoulSize = {:t}",
-                        capacity,
-                        containedSoulSize);
-
-                    const auto& sourceSoulGems =
-                        soulGemMap.getSoulGemsWith(capacity, containedSoulSize);
-
-                    const bool result =
-                        fillSoulGem_(sourceSoulGems, d.victim().soulSize(), d);
-
-                    if (result) {
-                        // We've checked for soul relocation already. No need to
-                        // do that again here.
-                        if (containedSoulSize > SoulSize::None) {
-                            d.notifySoulTrapSuccess(
-                                SoulTrapSuccessMessage::SoulDisplaced,
-                                d.victim());
-                            d.victims().emplace(
-                                static_cast<SoulSize>(containedSoulSize));
-                        } else {
-                            d.notifySoulTrapSuccess(
-                                SoulTrapSuccessMessage::SoulCaptured,
-                                d.victim());
-                        }
-
-                        return true;
+            //
+            // The search order is precomputed in the soul tier table.
+            for (const auto& [capacity, containedSoulSize] :
+                 soulTiers.bestFitOrder(d.victim().soulSize())) {
+                if (capacity > maxSoulCapacityToSearch ||
+                    containedSoulSize >= maxContainedSoulSizeToSearch) {
+                    continue;
+                }
+
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
+                    "Looking up white soul gems with capacity = {:t}, "
+                    "containedSoulSize = {:t}",
+                    capacity,
+                    containedSoulSize);
+
+                const bool result = fillSoulGem_(
+                    capacity,
+                    containedSoulSize,
+                    d.victim().soulSize(),
+                    d);
+
+                if (result) {
+                    // We've checked for soul relocation already. No need to do
+                    // that again here.
+                    if (containedSoulSize > SoulSize::None) {
+                        d.notifySoulTrapSuccess(
+                            SoulTrapSuccessMessage::SoulDisplaced,
+                            d.victim());
+                        d.victims().emplace(containedSoulSize);
+                    } else {
+                        d.notifySoulTrapSuccess(
+                            SoulTrapSuccessMessage::SoulCaptured,
+                            d.victim());
                     }
+
+                    return true;
                 }
             }
 
@@ -387,7 +258,9 @@ namespace {
             if (d.config[BC::AllowSoulDisplacement] &&
                 (d.config[BC::AllowPartiallyFillingSoulGems] ||
                  d.victim().soulSize() == SoulSize::Grand)) {
-                LOG_TRACE("Looking up dual soul filled gems with a black soul");
+                LOG_CHANNEL_TRACE(
+                    LogChannel::Trap,
+                    "Looking up dual soul filled gems with a black soul");
 
                 const bool result =
                     tryReplaceBlackSoulInDualSoulGemWithWhiteSoul_(d);
@@ -416,40 +289,42 @@ namespace {
             //             Return
             //         Else
             //             Continue searching
-            for (SoulSizeValue containedSoulSize = SoulSize::None;
-                 containedSoulSize < maxContainedSoulSizeToSearch;
-                 ++containedSoulSize) {
-                for (SoulGemCapacityValue capacity =
-                         toSoulGemCapacity(d.victim().soulSize());
-                     capacity <= maxSoulCapacityToSearch;
-                     ++capacity) {
-                    LOG_TRACE_FMT(
-                        "Looking up white soul gems with capacity = {:t}, "
-                        "containedSoulSize = {:t}",
-                        capacity,
-                        containedSoulSize);
-
-                    const bool result = fillWhiteSoulGem_(
-                        capacity,
-                        containedSoulSize,
-                        d.victim().soulSize(),
-                        d);
-
-                    if (result) {
-                        // We've checked for soul relocation already. No need to
-                        // do that again here.
-                        if (containedSoulSize > SoulSize::None) {
-                            d.notifySoulTrapSuccess(
-                                SoulTrapSuccessMessage::SoulDisplaced,
-                                d.victim());
-                        } else {
-                            d.notifySoulTrapSuccess(
-                                SoulTrapSuccessMessage::SoulCaptured,
-                                d.victim());
-                        }
-
-                        return true;
+            //
+            // The search order is precomputed in the soul tier table.
+            for (const auto& [capacity, containedSoulSize] :
+                 soulTiers.leastDisplacementOrder(d.victim().soulSize())) {
+                if (capacity > maxSoulCapacityToSearch ||
+                    containedSoulSize >= maxContainedSoulSizeToSearch) {
+                    continue;
+                }
+
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
+                    "Looking up white soul gems with capacity = {:t}, "
+                    "containedSoulSize = {:t}",
+                    capacity,
+                    containedSoulSize);
+
+                const bool result = fillSoulGem_(
+                    capacity,
+                    containedSoulSize,
+                    d.victim().soulSize(),
+                    d);
+
+                if (result) {
+                    // We've checked for soul relocation already. No need to do
+                    // that again here.
+                    if (containedSoulSize > SoulSize::None) {
+                        d.notifySoulTrapSuccess(
+                            SoulTrapSuccessMessage::SoulDisplaced,
+                            d.victim());
+                    } else {
+                        d.notifySoulTrapSuccess(
+                            SoulTrapSuccessMessage::SoulCaptured,
+                            d.victim());
                     }
+
+                    return true;
                 }
             }
         }
@@ -460,9 +335,7 @@ namespace {
     template <bool AllowSoulDisplacement>
     bool trapShrunkSoul_(SoulTrapData& d)
     {
-        LOG_TRACE("Trapping shrunk white soul..."sv);
-
-        const auto& soulGemMap = YASTMConfig::getInstance().soulGemMap();
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Trapping shrunk white soul..."sv);
 
         // Avoid shrinking a soul more than necessary. Any soul we displace must
         // be smaller than the soul gem capacity itself, and shrunk souls always
@@ -496,17 +369,18 @@ namespace {
             for (SoulSizeValue containedSoulSize = SoulSize::None;
                  containedSoulSize < maxContainedSoulSizeToSearch;
                  ++containedSoulSize) {
-                LOG_TRACE_FMT(
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
                     "Looking up white soul gems with capacity = {:t}, "
                     "containedSoulSize = {:t}",
                     capacity,
                     containedSoulSize);
 
-                const auto& sourceSoulGems =
-                    soulGemMap.getSoulGemsWith(capacity, containedSoulSize);
-
-                const bool isFillSuccessful =
-                    fillSoulGem_(sourceSoulGems, toSoulSize(capacity), d);
+                const bool isFillSuccessful = fillSoulGem_(
+                    capacity,
+                    containedSoulSize,
+                    toSoulSize(capacity),
+                    d);
 
                 if (isFillSuccessful) {
                     d.notifySoulTrapSuccess(
@@ -535,9 +409,7 @@ namespace {
 
     bool trapSplitSoul_(SoulTrapData& d)
     {
-        LOG_TRACE("Trapping split white soul...");
-
-        const auto& soulGemMap = YASTMConfig::getInstance().soulGemMap();
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Trapping split white soul...");
 
         // Don't look up non-empty soul gems if we can't displace souls.
         //
@@ -563,18 +435,18 @@ namespace {
         for (SoulSizeValue containedSoulSize = SoulSize::None;
              containedSoulSize < maxContainedSoulSizeToSearch;
              ++containedSoulSize) {
-            LOG_TRACE_FMT(
+            LOG_CHANNEL_TRACE_FMT(
+                LogChannel::Trap,
                 "Looking up white soul gems with capacity = {:t}, "
                 "containedSoulSize = {:t}",
                 d.victim().soulSize(),
                 containedSoulSize);
 
-            const auto& sourceSoulGems = soulGemMap.getSoulGemsWith(
+            const bool result = fillSoulGem_(
                 toSoulGemCapacity(d.victim().soulSize()),
-                containedSoulSize);
-
-            const bool result =
-                fillSoulGem_(sourceSoulGems, d.victim().soulSize(), d);
+                containedSoulSize,
+                d.victim().soulSize(),
+                d);
 
             if (result) {
                 d.notifySoulTrapSuccess(
@@ -594,72 +466,335 @@ namespace {
         return false;
     }
 
-    void splitSoul_(const Victim& victim, VictimsQueue& victimQueue)
+    /**
+     * @brief Records a soul that has been dropped from the victims queue
+     * without being placed in a soul gem.
+     *
+     * Unsplit primary souls are not counted since they're already reported
+     * through the soul trap outcome.
+     */
+    void discardSoul_(const Victim& victim)
     {
-        // Raw Soul Sizes:
-        // - Grand   = 3000 = Greater + Common
-        // - Greater = 2000 = Common + Common
-        // - Common  = 1000 = Lesser + Lesser
-        // - Lesser  = 500  = Petty + Petty
-        // - Petty   = 250
-        switch (victim.soulSize()) {
-        // Do not split black souls.
-        // case SoulSize::Black:
-        case SoulSize::Grand:
-            victimQueue.emplace(victim.actor(), SoulSize::Greater, true);
-            victimQueue.emplace(victim.actor(), SoulSize::Common, true);
-            break;
-        case SoulSize::Greater:
-            victimQueue.emplace(victim.actor(), SoulSize::Common, true);
-            victimQueue.emplace(victim.actor(), SoulSize::Common, true);
-            break;
-        case SoulSize::Common:
-            victimQueue.emplace(victim.actor(), SoulSize::Lesser, true);
-            victimQueue.emplace(victim.actor(), SoulSize::Lesser, true);
-            break;
-        case SoulSize::Lesser:
-            victimQueue.emplace(victim.actor(), SoulSize::Petty, true);
-            victimQueue.emplace(victim.actor(), SoulSize::Petty, true);
-            break;
+        if (victim.isSecondarySoul() || victim.isSplitSoul()) {
+            LOG_CHANNEL_TRACE_FMT(
+                LogChannel::Trap,
+                "Discarding soul: {}",
+                victim);
+            Metrics::getInstance().recordDiscardedSoul(victim.soulSize());
         }
     }
 
+    void splitSoul_(
+        const Victim& victim,
+        VictimsQueue& victimQueue,
+        const SoulTierTable& soulTiers)
+    {
+        // Black souls are never split. The decomposition of white souls is
+        // generated from the configured raw soul values.
+        if (victim.soulSize() == SoulSize::Black) {
+            discardSoul_(victim);
+            return;
+        }
+
+        if (const auto& split = soulTiers.split(victim.soulSize());
+            split.isSplittable()) {
+            victimQueue.emplace(victim.actor(), split.first, true);
+            victimQueue.emplace(victim.actor(), split.second, true);
+        } else {
+            discardSoul_(victim);
+        }
+    }
+
+    /**
+     * @brief Places the souls in the victims queue into the caster's soul gems,
+     * splitting and displacing souls as configured.
+     *
+     * If deferredSouls is not null, secondary (displaced) souls are appended to
+     * it instead of being relocated.
+     *
+     * @returns true if any soul was placed in a soul gem.
+     */
+    bool processVictims_(
+        SoulTrapData& d,
+        std::vector<SoulSize>* const deferredSouls)
+    {
+        bool isSoulTrapSuccessful = false;
+
+        while (!d.victims().empty()) {
+            if (deferredSouls != nullptr &&
+                d.victims().top().isSecondarySoul()) {
+                // Relocated later. Checked before updating the loop variables
+                // so the caster inventory isn't scanned again for it.
+                deferredSouls->push_back(d.victims().top().soulSize());
+                d.victims().pop();
+                continue;
+            }
+
+            d.updateLoopVariables();
+
+            LOG_CHANNEL_TRACE_FMT(
+                LogChannel::Trap,
+                "Processing soul trap victim: {}",
+                d.victim());
+
+            if (d.casterInventoryStatus() !=
+                InventoryStatus::HasSoulGemsToFill) {
+                // Caster doesn't have any soul gems. Stop looking.
+                LOG_CHANNEL_TRACE(
+                    LogChannel::Trap,
+                    "Caster has no soul gems to fill. Stop looking.");
+
+                discardSoul_(d.victim());
+
+                for (; !d.victims().empty(); d.victims().pop()) {
+                    discardSoul_(d.victims().top());
+                }
+
+                break;
+            }
+
+            if (d.victim().soulSize() == SoulSize::Black) {
+                if (trapBlackSoul_(d)) {
+                    isSoulTrapSuccessful = true;
+                    continue; // Process next soul.
+                }
+            } else if (d.victim().isSplitSoul()) {
+                assert(
+                    d.config.get<EC::SoulShrinkingTechnique>() ==
+                    SoulShrinkingTechnique::Split);
+
+                if (trapSplitSoul_(d)) {
+                    isSoulTrapSuccessful = true;
+                    continue; // Process next soul.
+                }
+
+                splitSoul_(
+                    d.victim(),
+                    d.victims(),
+                    d.backend().soulTiers());
+                continue; // Process next soul.
+            } else {
+                if (trapFullSoul_(d)) {
+                    isSoulTrapSuccessful = true;
+                    continue; // Process next soul.
+                }
+
+                // If we've reached this point, we start reducing the size of
+                // the soul.
+                //
+                // Standard soul shrinking is prioritized over soul splitting.
+                // Enabling both will implicitly turn off soul splitting.
+                const auto soulShrinkingTechnique =
+                    d.config.get<EC::SoulShrinkingTechnique>();
+
+                if (soulShrinkingTechnique == SoulShrinkingTechnique::Shrink) {
+                    if (trapShrunkSoul_(d)) {
+                        isSoulTrapSuccessful = true;
+                        continue; // Process next soul.
+                    }
+                } else if (
+                    soulShrinkingTechnique == SoulShrinkingTechnique::Split) {
+                    splitSoul_(
+                        d.victim(),
+                        d.victims(),
+                        d.backend().soulTiers());
+                    continue; // Process next soul.
+                }
+            }
+
+            discardSoul_(d.victim());
+        }
+
+        return isSoulTrapSuccessful;
+    }
+
+    /**
+     * @brief Captures the caster's soul gems for a shadow mode dry run if this
+     * soul trap is sampled. Call before any soul is placed.
+     */
+    std::optional<ShadowTrapRunner::Run> sampleShadowRun_(SoulTrapData& d)
+    {
+        auto strategy = d.backend().sampleShadowRun(d.config);
+
+        if (!strategy.has_value() || d.victims().empty()) {
+            return std::nullopt;
+        }
+
+        // The real soul trap reuses this scan, so this doesn't scan the
+        // inventory any more often than usual.
+        return ShadowTrapRunner::Run{
+            .inventory = d.inventory().countSoulGems(),
+            .inventoryStatus = d.casterInventoryStatus(),
+            .soulSize = d.victims().top().soulSize(),
+            .strategy = strategy.value(),
+            .productionOutcome = TrapOutcome::Error,
+            .productionPlacementDuration = {},
+        };
+    }
+
     std::mutex trapSoulMutex_; /* Process only one soul trap at a time. */
+
+    /**
+     * @brief Displaced souls waiting to be relocated, keyed by the caster's
+     * form ID. Guarded by trapSoulMutex_.
+     */
+    std::unordered_map<SoulTrapBackend::FormID, std::vector<SoulSize>>
+        deferredSouls_;
+
+    /**
+     * @brief Relocates the displaced souls deferred for the given caster, if
+     * any. Must be called with trapSoulMutex_ held.
+     */
+    void relocateDeferredSouls_(
+        const SoulTrapBackend::FormID casterFormId,
+        SoulTrapBackend& backend)
+    {
+        const auto node = deferredSouls_.extract(casterFormId);
+
+        if (node.empty()) {
+            return;
+        }
+
+        const auto& soulSizes = node.mapped();
+
+        LOG_CHANNEL_TRACE_FMT(
+            LogChannel::Trap,
+            "Relocating {} deferred soul(s) for caster {:08X}",
+            soulSizes.size(),
+            casterFormId);
+
+        RE::Actor* const caster = backend.lookupActor(casterFormId);
+
+        if (caster == nullptr || backend.isDead(caster)) {
+            for (const auto soulSize : soulSizes) {
+                discardSoul_(Victim(soulSize));
+            }
+
+            return;
+        }
+
+        try {
+            SoulTrapData d(backend, caster);
+
+            for (const auto soulSize : soulSizes) {
+                d.victims().emplace(soulSize);
+            }
+
+            processVictims_(d, nullptr);
+        } catch (const std::exception& error) {
+            printError(error);
+        }
+    }
+
+    /**
+     * @brief Queues displaced souls to be relocated on the next main thread
+     * task tick. Must be called with trapSoulMutex_ held.
+     */
+    void deferSoulRelocation_(
+        const SoulTrapBackend::FormID casterFormId,
+        const std::vector<SoulSize>& soulSizes,
+        SoulTrapBackend& backend)
+    {
+        auto& pendingSoulSizes = deferredSouls_[casterFormId];
+        const bool isTaskQueued = !pendingSoulSizes.empty();
+
+        pendingSoulSizes.insert(
+            pendingSoulSizes.end(),
+            soulSizes.begin(),
+            soulSizes.end());
+
+        // One task per caster is enough. Souls deferred before it runs are
+        // picked up by the task that's already queued.
+        if (!isTaskQueued) {
+            backend.addTask([casterFormId, &backend]() {
+                std::lock_guard<std::mutex> guard(trapSoulMutex_);
+                relocateDeferredSouls_(casterFormId, backend);
+            });
+        }
+    }
+
+    /**
+     * @brief Records the outcome and duration of a trapSoul() call to Metrics
+     * upon destruction. Metrics ignores the duration of rejected calls.
+     */
+    class TrapMetricsRecorder_ {
+        using clock_type = std::chrono::steady_clock;
+
+        clock_type::time_point begin_ = clock_type::now();
+        TrapOutcome outcome_ = TrapOutcome::Rejected;
+        SoulSize victimSoulSize_ = SoulSize::None;
+
+    public:
+        ~TrapMetricsRecorder_()
+        {
+            Metrics::getInstance().recordTrap(
+                outcome_,
+                victimSoulSize_,
+                clock_type::now() - begin_);
+        }
+
+        TrapOutcome outcome() const noexcept { return outcome_; }
+
+        void setOutcome(const TrapOutcome outcome) noexcept
+        {
+            outcome_ = outcome;
+        }
+
+        void setVictimSoulSize(const SoulSize soulSize) noexcept
+        {
+            victimSoulSize_ = soulSize;
+        }
+    };
 } // namespace
 
-bool trapSoul(RE::Actor* const caster, RE::Actor* const victim)
+bool trapSoul(
+    RE::Actor* const caster,
+    RE::Actor* const victim,
+    SoulTrapBackend& backend)
 {
+    TrapMetricsRecorder_ metrics;
+
     if (caster == nullptr) {
-        LOG_TRACE("Caster is null.");
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Caster is null.");
         return false;
     }
 
     if (victim == nullptr) {
-        LOG_TRACE("Victim is null.");
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Victim is null.");
         return false;
     }
 
-    if (caster->IsDead(false)) {
-        LOG_TRACE("Caster is dead.");
+    if (backend.isDead(caster)) {
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Caster is dead.");
         return false;
     }
 
-    if (!victim->IsDead(false)) {
-        LOG_TRACE("Victim is not dead.");
+    if (!backend.isDead(victim)) {
+        LOG_CHANNEL_TRACE(LogChannel::Trap, "Victim is not dead.");
         return false;
     }
 
     // We begin the mutex here since we're checking isSoulTrapped status next.
+    const auto lockWaitBegin = std::chrono::steady_clock::now();
     std::lock_guard<std::mutex> guard(trapSoulMutex_);
+    Metrics::getInstance().recordTrapLockWait(
+        std::chrono::steady_clock::now() - lockWaitBegin);
 
-    if (native::getRemainingSoulLevelValue(victim) == SoulLevelValue::None) {
-        LOG_TRACE("Victim has already been soul trapped.");
+    // Souls displaced by an earlier trap from this caster must be relocated
+    // first so they don't end up in soul gems this trap is about to fill.
+    relocateDeferredSouls_(backend.getFormId(caster), backend);
+
+    if (backend.isSoulTrapped(victim)) {
+        LOG_CHANNEL_TRACE(
+            LogChannel::Trap,
+            "Victim has already been soul trapped.");
         return false;
     }
 
-    bool isSoulTrapSuccessful = false;
-
     try {
+        const auto victimSoulSize = backend.getSoulSize(victim);
+        metrics.setVictimSoulSize(victimSoulSize);
+
         // Initialize the data we're going to pass around to various functions.
         //
         // Includes:
@@ -667,53 +802,74 @@ bool trapSoul(RE::Actor* const caster, RE::Actor* const victim)
         //            first. Needed for handling displaced souls.
         // - config:  a snapshot of the configuration so it would be immune to
         //            external changes for this particular call.
-        SoulTrapData d(caster);
+        SoulTrapData d(backend, caster);
+        std::vector<SoulSize> deferredSouls;
 
         switch (d.config.get<EC::SoulTrapLevelingType>()) {
         case SoulTrapLevelingType::Degradation:
             {
                 const auto maxSoulSize = d.maxTrappableSoulSize();
-                LOG_TRACE_FMT("Max trappable soul size: {:tu}", maxSoulSize);
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
+                    "Max trappable soul size: {:tu}",
+                    maxSoulSize);
 
                 if (maxSoulSize == SoulSize::None) {
-                    LOG_TRACE(
+                    LOG_CHANNEL_TRACE(
+                        LogChannel::Trap,
                         "Caster conjuration level is too low for any soul "
                         "trap.");
                     d.notifySoulTrapFailure(SoulTrapFailureMessage::SoulLost);
+                    metrics.setOutcome(TrapOutcome::SoulLost);
                     return false;
                 }
 
-                auto victimSoulSize = getActorSoulSize(victim);
-                LOG_TRACE_FMT("Victim's soul size: {:tu}", maxSoulSize);
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
+                    "Victim's soul size: {:tu}",
+                    maxSoulSize);
 
                 // Black souls can't be degraded. Reject entirely.
                 if (victimSoulSize == SoulSize::Black &&
                     maxSoulSize < SoulSize::Black) {
-                    LOG_TRACE(
+                    LOG_CHANNEL_TRACE(
+                        LogChannel::Trap,
                         "Caster conjuration level is too low to trap black "
                         "souls.");
                     d.notifySoulTrapFailure(SoulTrapFailureMessage::SoulLost);
+                    metrics.setOutcome(TrapOutcome::SoulLost);
                     return false;
                 }
 
                 if (victimSoulSize > maxSoulSize) {
-                    LOG_TRACE_FMT("Degraded soul size: {}", maxSoulSize);
+                    LOG_CHANNEL_TRACE_FMT(
+                        LogChannel::Trap,
+                        "Degraded soul size: {}",
+                        maxSoulSize);
                     d.victims().emplace(victim, maxSoulSize, false);
                     d.setDegradedSoulTrap();
                 } else {
-                    d.victims().emplace(victim);
+                    d.victims().emplace(victim, victimSoulSize, false);
                 }
                 break;
             }
         case SoulTrapLevelingType::Loss:
             {
-                const auto victimSoulSize = getActorSoulSize(victim);
-                LOG_TRACE_FMT("Victim's soul size: {:tu}", victimSoulSize);
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
+                    "Victim's soul size: {:tu}",
+                    victimSoulSize);
 
                 const auto levelThreshold =
                     d.getThresholdForSoulSize(victimSoulSize);
-                LOG_TRACE_FMT("Threshold level for victim: {}", levelThreshold);
-                LOG_TRACE_FMT("Caster soul trap level: {}", d.soulTrapLevel());
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
+                    "Threshold level for victim: {}",
+                    levelThreshold);
+                LOG_CHANNEL_TRACE_FMT(
+                    LogChannel::Trap,
+                    "Caster soul trap level: {}",
+                    d.soulTrapLevel());
 
                 if (d.soulTrapLevel() < levelThreshold) {
                     const auto scaling =
@@ -730,90 +886,59 @@ bool trapSoul(RE::Actor* const caster, RE::Actor* const victim)
 
                     const auto x = Rng::getInstance().generateUniform(0.0, 1.0);
 
-                    LOG_TRACE_FMT("chance={}, x={}", chanceThreshold, x);
+                    LOG_CHANNEL_TRACE_FMT(
+                        LogChannel::Trap,
+                        "chance={}, x={}",
+                        chanceThreshold,
+                        x);
 
                     if (chanceThreshold < x) {
-                        LOG_TRACE("Soul lost.");
+                        LOG_CHANNEL_TRACE(LogChannel::Trap, "Soul lost.");
                         d.notifySoulTrapFailure(
                             SoulTrapFailureMessage::SoulLost);
+                        metrics.setOutcome(TrapOutcome::SoulLost);
                         return false;
                     }
                 }
 
-                d.victims().emplace(victim);
+                d.victims().emplace(victim, victimSoulSize, false);
                 break;
             }
         default:
-            d.victims().emplace(victim);
+            d.victims().emplace(victim, victimSoulSize, false);
             break;
         }
 
-        while (!d.victims().empty()) {
-            d.updateLoopVariables();
-
-            LOG_TRACE_FMT("Processing soul trap victim: {}", d.victim());
-
-            if (d.casterInventoryStatus() !=
-                InventoryStatus::HasSoulGemsToFill) {
-                // Caster doesn't have any soul gems. Stop looking.
-                LOG_TRACE("Caster has no soul gems to fill. Stop looking.");
-                break;
-            }
-
-            if (d.victim().soulSize() == SoulSize::Black) {
-                if (trapBlackSoul_(d)) {
-                    isSoulTrapSuccessful = true;
-                    continue; // Process next soul.
-                }
-            } else if (d.victim().isSplitSoul()) {
-                assert(
-                    d.config.get<EC::SoulShrinkingTechnique>() ==
-                    SoulShrinkingTechnique::Split);
+        using clock_type = std::chrono::steady_clock;
 
-                if (trapSplitSoul_(d)) {
-                    isSoulTrapSuccessful = true;
-                    continue; // Process next soul.
-                }
+        auto shadowRun = sampleShadowRun_(d);
+        const auto placementBegin = shadowRun.has_value()
+                                        ? clock_type::now()
+                                        : clock_type::time_point();
 
-                splitSoul_(d.victim(), d.victims());
-                continue; // Process next soul.
-            } else {
-                if (trapFullSoul_(d)) {
-                    isSoulTrapSuccessful = true;
-                    continue; // Process next soul.
-                }
+        // Only the primary soul is placed here. Displaced souls don't affect
+        // the result and are relocated on the next main thread task tick so
+        // they don't add to the time spent in the hook.
+        const bool isSoulTrapSuccessful = processVictims_(d, &deferredSouls);
 
-                // If we've reached this point, we start reducing the size of
-                // the soul.
-                //
-                // Standard soul shrinking is prioritized over soul splitting.
-                // Enabling both will implicitly turn off soul splitting.
-                const auto soulShrinkingTechnique =
-                    d.config.get<EC::SoulShrinkingTechnique>();
+        if (shadowRun.has_value()) {
+            shadowRun->productionPlacementDuration =
+                clock_type::now() - placementBegin;
+        }
 
-                if (soulShrinkingTechnique == SoulShrinkingTechnique::Shrink) {
-                    if (trapShrunkSoul_(d)) {
-                        isSoulTrapSuccessful = true;
-                        continue; // Process next soul.
-                    }
-                } else if (
-                    soulShrinkingTechnique == SoulShrinkingTechnique::Split) {
-                    splitSoul_(d.victim(), d.victims());
-                    continue; // Process next soul.
-                }
-            }
+        if (!deferredSouls.empty()) {
+            deferSoulRelocation_(
+                backend.getFormId(caster),
+                deferredSouls,
+                backend);
         }
 
         if (isSoulTrapSuccessful) {
+            metrics.setOutcome(TrapOutcome::Success);
+
             // Flag the victim so we don't soul trap the same one multiple
             // times.
-            if (RE::AIProcess* const process = victim->currentProcess;
-                process) {
-                if (process->middleHigh) {
-                    LOG_TRACE("Flagging soul trapped victim...");
-                    process->middleHigh->soulTrapped = true;
-                }
-            }
+            backend.flagSoulTrapped(victim);
         } else {
             // Shorten it so we can keep it in one line after formatting for
             // readability.
@@ -822,23 +947,33 @@ bool trapSoul(RE::Actor* const caster, RE::Actor* const victim)
             switch (d.casterInventoryStatus()) {
             case InventoryStatus::AllSoulGemsFilled:
                 d.notifySoulTrapFailure(Message::AllSoulGemsFilled);
+                metrics.setOutcome(TrapOutcome::AllSoulGemsFilled);
                 break;
             case InventoryStatus::NoSoulGemsOwned:
                 d.notifySoulTrapFailure(Message::NoSoulGemsOwned);
+                metrics.setOutcome(TrapOutcome::NoSoulGemsOwned);
                 break;
             default:
                 if (d.config.get<EC::SoulShrinkingTechnique>() !=
                     SoulShrinkingTechnique::None) {
                     d.notifySoulTrapFailure(Message::NoSuitableSoulGem);
+                    metrics.setOutcome(TrapOutcome::NoSuitableSoulGem);
                 } else {
                     d.notifySoulTrapFailure(Message::NoSoulGemLargeEnough);
+                    metrics.setOutcome(TrapOutcome::NoSoulGemLargeEnough);
                 }
             }
         }
 
+        if (shadowRun.has_value()) {
+            shadowRun->productionOutcome = metrics.outcome();
+            backend.submitShadowRun(std::move(*shadowRun));
+        }
+
         return isSoulTrapSuccessful;
     } catch (const std::exception& error) {
         printError(error);
+        metrics.setOutcome(TrapOutcome::Error);
     }
 
     return false;
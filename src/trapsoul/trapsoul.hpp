@@ -1,32 +1,23 @@
 #pragma once
 
-#include <RE/A/Actor.h>
-#include <RE/P/PlayerCharacter.h>
+#include "SoulTrapBackend.hpp"
 
-#include "../global.hpp"
-#include "../config/ConfigKey/BoolConfigKey.hpp"
-#include "../config/YASTMConfig.hpp"
+namespace RE {
+    class Actor;
+} // namespace RE
 
+/**
+ * @brief Traps the victim's soul into one of the caster's soul gems.
+ */
 bool trapSoul(RE::Actor* caster, RE::Actor* victim);
 
 /**
- * @brief Returns the caster the soul was diverted to, if any.
+ * @brief Traps the victim's soul using the given backend for all game
+ * operations.
  */
-inline RE::Actor* getProxyCaster(RE::Actor* caster)
-{
-    const auto& config = YASTMConfig::getInstance();
-
-    if (config.getGlobalBool(BoolConfigKey::AllowSoulDiversion) &&
-        caster->IsPlayerTeammate()) {
-        const auto playerActor = RE::PlayerCharacter::GetSingleton();
+bool trapSoul(RE::Actor* caster, RE::Actor* victim, SoulTrapBackend& backend);
 
-        if (playerActor != nullptr) {
-            LOG_TRACE("Soul trap diverted to player."sv);
-            return playerActor;
-        } else {
-            LOG_WARN("Failed to find player reference for soul diversion.");
-        }
-    }
-
-    return caster;
-}
+/**
+ * @brief Returns the caster the soul was diverted to, if any.
+ */
+RE::Actor* getProxyCaster(RE::Actor* caster);
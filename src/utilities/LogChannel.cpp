@@ -0,0 +1,222 @@
+#include "LogChannel.hpp"
+
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "stringutils.hpp"
+
+using namespace std::literals;
+
+namespace {
+#ifdef NDEBUG
+    constexpr auto DEFAULT_LOG_LEVEL_ = spdlog::level::info;
+#else
+    constexpr auto DEFAULT_LOG_LEVEL_ = spdlog::level::trace;
+#endif
+
+    constexpr auto DEFAULT_RATE_LIMIT_WINDOW_ = 10s;
+} // namespace
+
+std::optional<LogChannel> fromLogChannelString(const std::string_view str)
+{
+    const auto lowerStr = getLowerString(str);
+    std::optional<LogChannel> result;
+
+    forEachLogChannel([&](const LogChannel channel) {
+        if (lowerStr == toString(channel)) {
+            result = channel;
+        }
+    });
+
+    return result;
+}
+
+std::optional<spdlog::level::level_enum>
+    fromLogLevelString(const std::string_view str)
+{
+    using spdlog::level::level_enum;
+
+    const auto lowerStr = getLowerString(str);
+
+    if (lowerStr == "warn"sv) {
+        return level_enum::warn;
+    }
+
+    if (lowerStr == "err"sv) {
+        return level_enum::err;
+    }
+
+    for (int i = level_enum::trace; i < level_enum::n_levels; ++i) {
+        const auto level = static_cast<level_enum>(i);
+
+        if (const auto name = spdlog::level::to_string_view(level);
+            lowerStr == std::string_view(name.data(), name.size())) {
+            return level;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::size_t LogChannelRegistry::RateLimitKeyHash::operator()(
+    const RateLimitKey& key) const noexcept
+{
+    std::size_t seed = 0;
+    boost::hash_combine(seed, std::hash<std::string_view>{}(key.filename));
+    boost::hash_combine(seed, key.line);
+    boost::hash_combine(seed, static_cast<int>(key.channel));
+    boost::hash_combine(seed, static_cast<int>(key.level));
+    boost::hash_combine(seed, std::hash<std::string>{}(key.message));
+    return seed;
+}
+
+LogChannelRegistry::LogChannelRegistry()
+    : rateLimitWindow_(
+          std::chrono::duration_cast<clock_type::duration>(
+              DEFAULT_RATE_LIMIT_WINDOW_)
+              .count())
+{
+    for (auto& level : levels_) { level.store(DEFAULT_LOG_LEVEL_); }
+}
+
+void LogChannelRegistry::setLevel(
+    const spdlog::level::level_enum level) noexcept
+{
+    for (auto& channelLevel : levels_) {
+        channelLevel.store(level, std::memory_order_relaxed);
+    }
+}
+
+void LogChannelRegistry::setRateLimitWindow(
+    const std::chrono::milliseconds window) noexcept
+{
+    rateLimitWindow_.store(
+        std::chrono::duration_cast<clock_type::duration>(window).count(),
+        std::memory_order_relaxed);
+}
+
+void LogChannelRegistry::logRateLimited(
+    const LogChannel channel,
+    const spdlog::source_loc& location,
+    const spdlog::level::level_enum level,
+    std::string message)
+{
+    RateLimitKey key{
+        location.filename,
+        location.line,
+        channel,
+        level,
+        std::move(message)};
+
+    const auto suppressedCount = acquireRateLimit_(key);
+
+    if (!suppressedCount.has_value()) {
+        return;
+    }
+
+    if (*suppressedCount > 0) {
+        spdlog::log(
+            location,
+            level,
+            "{} ({} identical message(s) suppressed since last logged)",
+            key.message,
+            *suppressedCount);
+    } else {
+        spdlog::log(location, level, "{}", key.message);
+    }
+}
+
+std::optional<std::size_t>
+    LogChannelRegistry::acquireRateLimit_(const RateLimitKey& key)
+{
+    const clock_type::duration window(
+        rateLimitWindow_.load(std::memory_order_relaxed));
+
+    if (window <= clock_type::duration::zero()) {
+        return 0;
+    }
+
+    const auto now = clock_type::now();
+
+    std::lock_guard lock(rateLimitMutex_);
+
+    if (const auto it = rateLimitIndex_.find(key);
+        it != rateLimitIndex_.end()) {
+        auto& entry = *it->second;
+
+        if (now - entry.lastLogged < window) {
+            ++entry.suppressedCount;
+            return std::nullopt;
+        }
+
+        entry.lastLogged = now;
+        // Keep the list ordered by the time each entry was last logged.
+        rateLimitEntries_.splice(
+            rateLimitEntries_.end(),
+            rateLimitEntries_,
+            it->second);
+
+        return std::exchange(entry.suppressedCount, 0);
+    }
+
+    pruneRateLimitEntries_(now, window);
+
+    if (rateLimitEntries_.size() >= MAX_RATE_LIMIT_ENTRIES_) {
+        evictOldestRateLimitEntry_();
+    }
+
+    rateLimitEntries_.push_back(RateLimitEntry{key, now, 0});
+    rateLimitIndex_.emplace(key, std::prev(rateLimitEntries_.end()));
+
+    return 0;
+}
+
+void LogChannelRegistry::pruneRateLimitEntries_(
+    const clock_type::time_point now,
+    const clock_type::duration window)
+{
+    // Entries are ordered by the time they were last logged, so expired
+    // entries are all at the front.
+    while (!rateLimitEntries_.empty() &&
+           now - rateLimitEntries_.front().lastLogged >= window) {
+        evictOldestRateLimitEntry_();
+    }
+}
+
+void LogChannelRegistry::evictOldestRateLimitEntry_()
+{
+    const auto& entry = rateLimitEntries_.front();
+
+    logSuppressedSummary_(entry);
+    rateLimitIndex_.erase(entry.key);
+    rateLimitEntries_.pop_front();
+}
+
+void LogChannelRegistry::logSuppressedSummary_(const RateLimitEntry& entry)
+{
+    if (entry.suppressedCount > 0) {
+        spdlog::log(
+            entry.key.level,
+            "[{}] Suppressed {} repeat(s) of message from {}:{}: {}",
+            toString(entry.key.channel),
+            entry.suppressedCount,
+            entry.key.filename,
+            entry.key.line,
+            entry.key.message);
+    }
+}
+
+void LogChannelRegistry::flushSuppressedSummaries()
+{
+    std::lock_guard lock(rateLimitMutex_);
+
+    for (const auto& entry : rateLimitEntries_) {
+        logSuppressedSummary_(entry);
+    }
+
+    rateLimitEntries_.clear();
+    rateLimitIndex_.clear();
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+/**
+ * @brief Named log channels. Each channel has its own log level that can be
+ * changed at runtime (from YASTM.toml or Papyrus).
+ */
+enum class LogChannel {
+    Config,
+    Trap,
+    Charge,
+    Enchant,
+    FSUtils,
+    Metrics,
+    Count,
+};
+
+inline constexpr std::string_view toString(const LogChannel channel) noexcept
+{
+    using namespace std::literals;
+
+    switch (channel) {
+    case LogChannel::Config:
+        return "config"sv;
+    case LogChannel::Trap:
+        return "trap"sv;
+    case LogChannel::Charge:
+        return "charge"sv;
+    case LogChannel::Enchant:
+        return "enchant"sv;
+    case LogChannel::FSUtils:
+        return "fsutils"sv;
+    case LogChannel::Metrics:
+        return "metrics"sv;
+    case LogChannel::Count:
+        return "<count>"sv;
+    }
+
+    return "<invalid LogChannel>"sv;
+}
+
+/**
+ * @brief Calls fn(channel) for each available log channel.
+ */
+inline void forEachLogChannel(const std::function<void(LogChannel)>& fn)
+{
+    fn(LogChannel::Config);
+    fn(LogChannel::Trap);
+    fn(LogChannel::Charge);
+    fn(LogChannel::Enchant);
+    fn(LogChannel::FSUtils);
+    fn(LogChannel::Metrics);
+}
+
+/**
+ * @brief Parses a log channel name. The name is case-insensitive.
+ */
+[[nodiscard]] std::optional<LogChannel>
+    fromLogChannelString(std::string_view str);
+
+/**
+ * @brief Parses a log level name. Accepts the spdlog level names ("trace",
+ * "debug", "info", "warning", "error", "critical", "off") as well as the short
+ * forms "warn" and "err". The name is case-insensitive.
+ */
+[[nodiscard]] std::optional<spdlog::level::level_enum>
+    fromLogLevelString(std::string_view str);
+
+/**
+ * @brief Stores the runtime log level for each log channel and handles
+ * rate limiting of repeated messages.
+ *
+ * Level checks are a single relaxed atomic load so they can be used on hot
+ * paths. Message formatting only happens after the check passes.
+ *
+ * Rate-limited messages are tracked by call site (source location, channel and
+ * level) and formatted message, so different messages from the same call site
+ * don't suppress each other.
+ */
+class LogChannelRegistry {
+    using clock_type = std::chrono::steady_clock;
+    using LevelArray = std::array<
+        std::atomic<spdlog::level::level_enum>,
+        static_cast<std::size_t>(LogChannel::Count)>;
+
+    /**
+     * @brief Identifies a rate-limited message. The file name is compared by
+     * content since the same file can have a different __FILE__ address in
+     * each translation unit.
+     */
+    struct RateLimitKey {
+        std::string_view filename;
+        int line;
+        LogChannel channel;
+        spdlog::level::level_enum level;
+        std::string message;
+
+        bool operator==(const RateLimitKey&) const = default;
+    };
+
+    struct RateLimitKeyHash {
+        std::size_t operator()(const RateLimitKey& key) const noexcept;
+    };
+
+    struct RateLimitEntry {
+        RateLimitKey key;
+        clock_type::time_point lastLogged;
+        std::size_t suppressedCount = 0;
+    };
+
+    /**
+     * @brief Ordered from least to most recently logged.
+     */
+    using RateLimitEntryList = std::list<RateLimitEntry>;
+
+    /**
+     * @brief Maximum number of tracked messages. The least recently logged
+     * entry is evicted when a new message would exceed this.
+     */
+    static constexpr std::size_t MAX_RATE_LIMIT_ENTRIES_ = 256;
+
+    LevelArray levels_;
+    std::atomic<clock_type::rep> rateLimitWindow_;
+
+    RateLimitEntryList rateLimitEntries_;
+    std::unordered_map<
+        RateLimitKey,
+        RateLimitEntryList::iterator,
+        RateLimitKeyHash>
+        rateLimitIndex_;
+    std::mutex rateLimitMutex_;
+
+    explicit LogChannelRegistry();
+
+    [[nodiscard]] std::optional<std::size_t>
+        acquireRateLimit_(const RateLimitKey& key);
+    void pruneRateLimitEntries_(
+        clock_type::time_point now,
+        clock_type::duration window);
+    void evictOldestRateLimitEntry_();
+    static void logSuppressedSummary_(const RateLimitEntry& entry);
+
+public:
+    LogChannelRegistry(const LogChannelRegistry&) = delete;
+    LogChannelRegistry(LogChannelRegistry&&) = delete;
+    LogChannelRegistry& operator=(const LogChannelRegistry&) = delete;
+    LogChannelRegistry& operator=(LogChannelRegistry&&) = delete;
+
+    static LogChannelRegistry& getInstance()
+    {
+        static LogChannelRegistry instance;
+        return instance;
+    }
+
+    [[nodiscard]] bool shouldLog(
+        const LogChannel channel,
+        const spdlog::level::level_enum level) const noexcept
+    {
+        return level >= levels_[static_cast<std::size_t>(channel)].load(
+                            std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] spdlog::level::level_enum
+        level(const LogChannel channel) const noexcept
+    {
+        return levels_[static_cast<std::size_t>(channel)].load(
+            std::memory_order_relaxed);
+    }
+
+    void setLevel(
+        const LogChannel channel,
+        const spdlog::level::level_enum level) noexcept
+    {
+        levels_[static_cast<std::size_t>(channel)].store(
+            level,
+            std::memory_order_relaxed);
+    }
+
+    void setLevel(spdlog::level::level_enum level) noexcept;
+
+    /**
+     * @brief Sets the window in which identical messages from the same call
+     * site are suppressed. A window of zero disables rate limiting.
+     */
+    void setRateLimitWindow(std::chrono::milliseconds window) noexcept;
+
+    /**
+     * @brief Logs the message unless the same message was already logged from
+     * the call site within the rate limit window, in which case it's counted
+     * as suppressed. The message that ends the window is logged along with the
+     * number of repeats it suppressed.
+     *
+     * The caller is expected to have checked shouldLog() already.
+     */
+    void logRateLimited(
+        LogChannel channel,
+        const spdlog::source_loc& location,
+        spdlog::level::level_enum level,
+        std::string message);
+
+    /**
+     * @brief Logs a summary for every message with pending suppressed repeats
+     * and resets the rate limiter.
+     */
+    void flushSuppressedSummaries();
+};
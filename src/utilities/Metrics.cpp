@@ -0,0 +1,402 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <fmt/format.h>
+
+using namespace std::literals;
+
+namespace {
+    std::uint64_t toNanoseconds_(
+        const std::chrono::steady_clock::duration duration) noexcept
+    {
+        const auto count =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                .count();
+
+        return count > 0 ? static_cast<std::uint64_t>(count) : 0;
+    }
+
+    double toSeconds_(const std::uint64_t nanoseconds) noexcept
+    {
+        return static_cast<double>(nanoseconds) / 1e9;
+    }
+
+    void writeHeader_(
+        std::string& out,
+        const std::string_view name,
+        const std::string_view type,
+        const std::string_view help)
+    {
+        fmt::format_to(
+            std::back_inserter(out),
+            "# HELP {} {}\n# TYPE {} {}\n",
+            name,
+            help,
+            name,
+            type);
+    }
+
+    template <typename T>
+    void writeSample_(
+        std::string& out,
+        const std::string_view name,
+        const std::string_view labels,
+        const T value)
+    {
+        if (labels.empty()) {
+            fmt::format_to(std::back_inserter(out), "{} {}\n", name, value);
+        } else {
+            fmt::format_to(
+                std::back_inserter(out),
+                "{}{{{}}} {}\n",
+                name,
+                labels,
+                value);
+        }
+    }
+} // namespace
+
+void LatencyHistogram::observe(const clock_type::duration duration) noexcept
+{
+    const auto nanoseconds = toNanoseconds_(duration);
+    const auto seconds = toSeconds_(nanoseconds);
+
+    // Index of the first bucket whose upper bound is >= seconds, or the +Inf
+    // bucket if there is none.
+    const auto index = static_cast<std::size_t>(std::distance(
+        BUCKET_BOUNDS.begin(),
+        std::lower_bound(BUCKET_BOUNDS.begin(), BUCKET_BOUNDS.end(), seconds)));
+
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    sumNanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::writeTo(
+    std::string& out,
+    const std::string_view name,
+    const std::string_view labels) const
+{
+    const auto separator = labels.empty() ? ""sv : ","sv;
+    std::uint64_t cumulativeCount = 0;
+
+    for (std::size_t i = 0; i < buckets_.size(); ++i) {
+        cumulativeCount += buckets_[i].load(std::memory_order_relaxed);
+
+        const auto bound = i < BUCKET_BOUNDS.size()
+                               ? fmt::format("{}", BUCKET_BOUNDS[i])
+                               : "+Inf"s;
+
+        fmt::format_to(
+            std::back_inserter(out),
+            "{}_bucket{{{}{}le=\"{}\"}} {}\n",
+            name,
+            labels,
+            separator,
+            bound,
+            cumulativeCount);
+    }
+
+    writeSample_(
+        out,
+        fmt::format("{}_sum", name),
+        labels,
+        toSeconds_(sumNanoseconds_.load(std::memory_order_relaxed)));
+    writeSample_(out, fmt::format("{}_count", name), labels, cumulativeCount);
+}
+
+void Metrics::recordTrap(
+    const TrapOutcome outcome,
+    const SoulSize victimSoulSize,
+    const clock_type::duration duration) noexcept
+{
+    trapCounts_[outcome][victimSoulSize].add();
+
+    // Rejected calls return within nanoseconds and make up most hook calls,
+    // so they would drown out the duration of the traps actually processed.
+    if (outcome != TrapOutcome::Rejected) {
+        trapDuration_.observe(duration);
+    }
+}
+
+void Metrics::recordTrapLockWait(const clock_type::duration duration) noexcept
+{
+    trapLockWaitNanoseconds_.add(toNanoseconds_(duration));
+    trapLockAcquisitions_.add();
+}
+
+void Metrics::recordConfigLoad(const clock_type::duration duration) noexcept
+{
+    configLoadSeconds_.set(toSeconds_(toNanoseconds_(duration)));
+    configLoads_.add();
+}
+
+void Metrics::recordShadowRun(
+    const TrapOutcome productionOutcome,
+    const TrapOutcome shadowOutcome,
+    const clock_type::duration productionPlacementDuration,
+    const clock_type::duration simulationDuration) noexcept
+{
+    shadowRuns_[productionOutcome][shadowOutcome].add();
+    shadowProductionPlacementDuration_.observe(productionPlacementDuration);
+    shadowSimulationDuration_.observe(simulationDuration);
+}
+
+void Metrics::recordFSUtilsLockWait(
+    const clock_type::duration duration) noexcept
+{
+    fsutilsLockWaitNanoseconds_.add(toNanoseconds_(duration));
+}
+
+std::string Metrics::toPrometheusText() const
+{
+    std::string out;
+
+    writeHeader_(
+        out,
+        "yastm_traps_total"sv,
+        "counter"sv,
+        "Soul trap calls by outcome and victim soul size."sv);
+
+    for (std::size_t i = 0; i < trapCounts_.size(); ++i) {
+        const auto outcome = static_cast<TrapOutcome>(i);
+
+        for (std::size_t j = 0; j < trapCounts_[outcome].size(); ++j) {
+            const auto soulSize = static_cast<SoulSize>(j);
+            const auto value = trapCounts_[outcome][soulSize].value();
+
+            // Skip empty series so the file doesn't balloon with zeroes.
+            if (value > 0) {
+                writeSample_(
+                    out,
+                    "yastm_traps_total"sv,
+                    fmt::format(
+                        "outcome=\"{}\",soul_size=\"{}\"",
+                        toString(outcome),
+                        toString(soulSize)),
+                    value);
+            }
+        }
+    }
+
+    writeHeader_(
+        out,
+        "yastm_trap_duration_seconds"sv,
+        "histogram"sv,
+        "Time taken by trapSoul(), including lock wait. Rejected calls are "
+        "not included."sv);
+    trapDuration_.writeTo(out, "yastm_trap_duration_seconds"sv);
+
+    writeHeader_(
+        out,
+        "yastm_trap_lock_wait_seconds_total"sv,
+        "counter"sv,
+        "Total time spent waiting for the soul trap lock."sv);
+    writeSample_(
+        out,
+        "yastm_trap_lock_wait_seconds_total"sv,
+        {},
+        toSeconds_(trapLockWaitNanoseconds_.value()));
+
+    writeHeader_(
+        out,
+        "yastm_trap_lock_acquisitions_total"sv,
+        "counter"sv,
+        "Number of times the soul trap lock was acquired."sv);
+    writeSample_(
+        out,
+        "yastm_trap_lock_acquisitions_total"sv,
+        {},
+        trapLockAcquisitions_.value());
+
+    writeHeader_(
+        out,
+        "yastm_discarded_souls_total"sv,
+        "counter"sv,
+        "Displaced and split souls lost because no soul gem could hold "
+        "them."sv);
+
+    for (std::size_t i = 0; i < discardedSouls_.size(); ++i) {
+        const auto soulSize = static_cast<SoulSize>(i);
+        const auto value = discardedSouls_[soulSize].value();
+
+        if (value > 0) {
+            writeSample_(
+                out,
+                "yastm_discarded_souls_total"sv,
+                fmt::format("soul_size=\"{}\"", toString(soulSize)),
+                value);
+        }
+    }
+
+    writeHeader_(
+        out,
+        "yastm_inventory_rescans_total"sv,
+        "counter"sv,
+        "Number of caster inventory scans for soul gems."sv);
+    writeSample_(
+        out,
+        "yastm_inventory_rescans_total"sv,
+        {},
+        inventoryRescans_.value());
+
+    writeHeader_(
+        out,
+        "yastm_inventory_rescan_duration_seconds"sv,
+        "histogram"sv,
+        "Time taken to scan the caster inventory for soul gems."sv);
+    inventoryRescanDuration_.writeTo(
+        out,
+        "yastm_inventory_rescan_duration_seconds"sv);
+
+    writeHeader_(
+        out,
+        "yastm_config_load_seconds"sv,
+        "gauge"sv,
+        "Time taken by the last configuration load."sv);
+    writeSample_(
+        out,
+        "yastm_config_load_seconds"sv,
+        {},
+        configLoadSeconds_.value());
+
+    writeHeader_(
+        out,
+        "yastm_config_loads_total"sv,
+        "counter"sv,
+        "Number of configuration loads."sv);
+    writeSample_(out, "yastm_config_loads_total"sv, {}, configLoads_.value());
+
+    writeHeader_(
+        out,
+        "yastm_fsutils_open_handles"sv,
+        "gauge"sv,
+        "Number of open YASTMFSUtils config handles."sv);
+    writeSample_(
+        out,
+        "yastm_fsutils_open_handles"sv,
+        {},
+        fsutilsOpenHandles_.value());
+
+    writeHeader_(
+        out,
+        "yastm_fsutils_bytes_read_total"sv,
+        "counter"sv,
+        "Bytes of config files opened through YASTMFSUtils."sv);
+    writeSample_(
+        out,
+        "yastm_fsutils_bytes_read_total"sv,
+        {},
+        fsutilsBytesRead_.value());
+
+    writeHeader_(
+        out,
+        "yastm_fsutils_bytes_written_total"sv,
+        "counter"sv,
+        "Bytes of config files saved through YASTMFSUtils."sv);
+    writeSample_(
+        out,
+        "yastm_fsutils_bytes_written_total"sv,
+        {},
+        fsutilsBytesWritten_.value());
+
+    writeHeader_(
+        out,
+        "yastm_fsutils_lock_wait_seconds_total"sv,
+        "counter"sv,
+        "Total time spent waiting for the YASTMFSUtils handle lock."sv);
+    writeSample_(
+        out,
+        "yastm_fsutils_lock_wait_seconds_total"sv,
+        {},
+        toSeconds_(fsutilsLockWaitNanoseconds_.value()));
+
+    writeHeader_(
+        out,
+        "yastm_soul_gem_consumptions_total"sv,
+        "counter"sv,
+        "Reusable soul gems consumed by charging or enchanting items."sv);
+
+    for (std::size_t i = 0; i < soulGemConsumptions_.size(); ++i) {
+        const auto consumer = static_cast<SoulGemConsumer>(i);
+
+        for (std::size_t j = 0; j < soulGemConsumptions_[consumer].size();
+             ++j) {
+            const auto consumption = static_cast<SoulGemConsumption>(j);
+
+            writeSample_(
+                out,
+                "yastm_soul_gem_consumptions_total"sv,
+                fmt::format(
+                    "consumer=\"{}\",result=\"{}\"",
+                    toString(consumer),
+                    toString(consumption)),
+                soulGemConsumptions_[consumer][consumption].value());
+        }
+    }
+
+    writeHeader_(
+        out,
+        "yastm_shadow_runs_total"sv,
+        "counter"sv,
+        "Shadow mode dry runs by real and shadow soul trap outcome."sv);
+
+    for (std::size_t i = 0; i < shadowRuns_.size(); ++i) {
+        const auto productionOutcome = static_cast<TrapOutcome>(i);
+
+        for (std::size_t j = 0; j < shadowRuns_[productionOutcome].size();
+             ++j) {
+            const auto shadowOutcome = static_cast<TrapOutcome>(j);
+            const auto value =
+                shadowRuns_[productionOutcome][shadowOutcome].value();
+
+            if (value > 0) {
+                writeSample_(
+                    out,
+                    "yastm_shadow_runs_total"sv,
+                    fmt::format(
+                        "production=\"{}\",shadow=\"{}\",diverged=\"{}\"",
+                        toString(productionOutcome),
+                        toString(shadowOutcome),
+                        productionOutcome != shadowOutcome),
+                    value);
+            }
+        }
+    }
+
+    // The two series below measure different work, so they're exported as
+    // separate metrics instead of labels of the same one.
+    writeHeader_(
+        out,
+        "yastm_shadow_production_placement_duration_seconds"sv,
+        "histogram"sv,
+        "Time taken by sampled real soul traps to place the primary soul, "
+        "including inventory scans and changes."sv);
+    shadowProductionPlacementDuration_.writeTo(
+        out,
+        "yastm_shadow_production_placement_duration_seconds"sv);
+
+    writeHeader_(
+        out,
+        "yastm_shadow_simulation_duration_seconds"sv,
+        "histogram"sv,
+        "Time taken to dry-run the shadow strategy on in-memory soul gem "
+        "counts. Not comparable with the production placement duration."sv);
+    shadowSimulationDuration_.writeTo(
+        out,
+        "yastm_shadow_simulation_duration_seconds"sv);
+
+    writeHeader_(
+        out,
+        "yastm_shadow_runs_dropped_total"sv,
+        "counter"sv,
+        "Shadow mode dry runs dropped because too many were pending."sv);
+    writeSample_(
+        out,
+        "yastm_shadow_runs_dropped_total"sv,
+        {},
+        shadowRunsDropped_.value());
+
+    return out;
+}
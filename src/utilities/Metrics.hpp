@@ -0,0 +1,340 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "EnumArray.hpp"
+#include "../SoulSize.hpp"
+
+/**
+ * @brief The result of a single call to trapSoul().
+ */
+enum class TrapOutcome {
+    /**
+     * @brief At least one soul (primary or displaced) was trapped.
+     */
+    Success,
+    /**
+     * @brief Trap was not processed (invalid caster/victim, or the victim has
+     * already been soul trapped).
+     */
+    Rejected,
+    SoulLost,
+    NoSoulGemsOwned,
+    AllSoulGemsFilled,
+    NoSoulGemLargeEnough,
+    NoSuitableSoulGem,
+    /**
+     * @brief An exception was thrown while processing the trap.
+     */
+    Error,
+    Size,
+};
+
+inline constexpr std::string_view toString(const TrapOutcome outcome) noexcept
+{
+    using namespace std::literals;
+
+    switch (outcome) {
+    case TrapOutcome::Success:
+        return "success"sv;
+    case TrapOutcome::Rejected:
+        return "rejected"sv;
+    case TrapOutcome::SoulLost:
+        return "soul_lost"sv;
+    case TrapOutcome::NoSoulGemsOwned:
+        return "no_soul_gems_owned"sv;
+    case TrapOutcome::AllSoulGemsFilled:
+        return "all_soul_gems_filled"sv;
+    case TrapOutcome::NoSoulGemLargeEnough:
+        return "no_soul_gem_large_enough"sv;
+    case TrapOutcome::NoSuitableSoulGem:
+        return "no_suitable_soul_gem"sv;
+    case TrapOutcome::Error:
+        return "error"sv;
+    case TrapOutcome::Size:
+        return "<size>"sv;
+    }
+
+    return "<invalid TrapOutcome>"sv;
+}
+
+/**
+ * @brief The patch that consumed a reusable soul gem.
+ */
+enum class SoulGemConsumer {
+    Charge,
+    Enchant,
+    Size,
+};
+
+inline constexpr std::string_view
+    toString(const SoulGemConsumer consumer) noexcept
+{
+    using namespace std::literals;
+
+    switch (consumer) {
+    case SoulGemConsumer::Charge:
+        return "charge"sv;
+    case SoulGemConsumer::Enchant:
+        return "enchant"sv;
+    case SoulGemConsumer::Size:
+        return "<size>"sv;
+    }
+
+    return "<invalid SoulGemConsumer>"sv;
+}
+
+/**
+ * @brief How a reusable soul gem was consumed.
+ */
+enum class SoulGemConsumption {
+    /**
+     * @brief The contained soul was stored in extra data and was cleared.
+     */
+    ExtraDataCleared,
+    /**
+     * @brief The soul gem was replaced with its base (empty) form.
+     */
+    ReplacedWithBaseForm,
+    /**
+     * @brief No base form was found and there was no extra data to clear.
+     */
+    BaseFormNotFound,
+    Size,
+};
+
+inline constexpr std::string_view
+    toString(const SoulGemConsumption consumption) noexcept
+{
+    using namespace std::literals;
+
+    switch (consumption) {
+    case SoulGemConsumption::ExtraDataCleared:
+        return "extra_data_cleared"sv;
+    case SoulGemConsumption::ReplacedWithBaseForm:
+        return "replaced_with_base_form"sv;
+    case SoulGemConsumption::BaseFormNotFound:
+        return "base_form_not_found"sv;
+    case SoulGemConsumption::Size:
+        return "<size>"sv;
+    }
+
+    return "<invalid SoulGemConsumption>"sv;
+}
+
+/**
+ * @brief A monotonically increasing counter.
+ */
+class MetricCounter {
+    std::atomic<std::uint64_t> value_ = 0;
+
+public:
+    void add(const std::uint64_t amount = 1) noexcept
+    {
+        value_.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    std::uint64_t value() const noexcept
+    {
+        return value_.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief A value that can go up and down.
+ */
+class MetricGauge {
+    std::atomic<double> value_ = 0.0;
+
+public:
+    void set(const double value) noexcept
+    {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    double value() const noexcept
+    {
+        return value_.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief A histogram of durations with fixed bucket bounds.
+ *
+ * Bucket counts are stored non-cumulatively and only summed when the
+ * histogram is written out, so each observation is a single relaxed increment
+ * (plus the sum and count updates).
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @brief Upper bounds of each bucket, in seconds. The last implicit bucket
+     * is +Inf.
+     */
+    static constexpr std::array BUCKET_BOUNDS = {
+        0.00001,
+        0.00005,
+        0.0001,
+        0.00025,
+        0.0005,
+        0.001,
+        0.0025,
+        0.005,
+        0.01,
+        0.025,
+        0.05,
+        0.1,
+    };
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    std::array<std::atomic<std::uint64_t>, BUCKET_BOUNDS.size() + 1> buckets_{};
+    std::atomic<std::uint64_t> sumNanoseconds_ = 0;
+
+public:
+    void observe(clock_type::duration duration) noexcept;
+
+    /**
+     * @brief Appends the histogram to out in Prometheus text exposition format.
+     *
+     * @param labels Label pairs without the surrounding braces, e.g.
+     * `consumer="charge"`. May be empty.
+     */
+    void writeTo(
+        std::string& out,
+        std::string_view name,
+        std::string_view labels = {}) const;
+};
+
+/**
+ * @brief Process-wide metrics for YASTM.
+ *
+ * All updates are relaxed atomic operations so they can be made from hooks
+ * on the game thread without locking. Reading (toPrometheusText()) is done by
+ * the metrics exporter thread; the values read are not a consistent snapshot
+ * across different metrics, which is fine for monitoring purposes.
+ */
+class Metrics {
+    using clock_type = std::chrono::steady_clock;
+
+    EnumArray<TrapOutcome, EnumArray<SoulSize, MetricCounter>> trapCounts_;
+    LatencyHistogram trapDuration_;
+    MetricCounter trapLockWaitNanoseconds_;
+    MetricCounter trapLockAcquisitions_;
+    EnumArray<SoulSize, MetricCounter> discardedSouls_;
+
+    MetricCounter inventoryRescans_;
+    LatencyHistogram inventoryRescanDuration_;
+
+    MetricGauge configLoadSeconds_;
+    MetricCounter configLoads_;
+
+    MetricGauge fsutilsOpenHandles_;
+    MetricCounter fsutilsBytesRead_;
+    MetricCounter fsutilsBytesWritten_;
+    MetricCounter fsutilsLockWaitNanoseconds_;
+
+    EnumArray<
+        SoulGemConsumer,
+        EnumArray<SoulGemConsumption, MetricCounter>>
+        soulGemConsumptions_;
+
+    EnumArray<TrapOutcome, EnumArray<TrapOutcome, MetricCounter>>
+        shadowRuns_;
+    LatencyHistogram shadowProductionPlacementDuration_;
+    LatencyHistogram shadowSimulationDuration_;
+    MetricCounter shadowRunsDropped_;
+
+    explicit Metrics() = default;
+
+public:
+    Metrics(const Metrics&) = delete;
+    Metrics(Metrics&&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+    Metrics& operator=(Metrics&&) = delete;
+
+    static Metrics& getInstance()
+    {
+        static Metrics instance;
+        return instance;
+    }
+
+    /**
+     * @brief Counts a trapSoul() call. The duration is only observed for calls
+     * that weren't rejected.
+     */
+    void recordTrap(
+        TrapOutcome outcome,
+        SoulSize victimSoulSize,
+        clock_type::duration duration) noexcept;
+
+    void recordTrapLockWait(clock_type::duration duration) noexcept;
+
+    /**
+     * @brief Records a displaced or split soul that couldn't be placed in any
+     * soul gem and was lost.
+     */
+    void recordDiscardedSoul(const SoulSize soulSize) noexcept
+    {
+        discardedSouls_[soulSize].add();
+    }
+
+    void recordInventoryRescan(clock_type::duration duration) noexcept
+    {
+        inventoryRescans_.add();
+        inventoryRescanDuration_.observe(duration);
+    }
+
+    void recordConfigLoad(clock_type::duration duration) noexcept;
+
+    void setFSUtilsOpenHandles(const std::size_t count) noexcept
+    {
+        fsutilsOpenHandles_.set(static_cast<double>(count));
+    }
+
+    void addFSUtilsBytesRead(const std::uint64_t bytes) noexcept
+    {
+        fsutilsBytesRead_.add(bytes);
+    }
+
+    void addFSUtilsBytesWritten(const std::uint64_t bytes) noexcept
+    {
+        fsutilsBytesWritten_.add(bytes);
+    }
+
+    void recordFSUtilsLockWait(clock_type::duration duration) noexcept;
+
+    void recordSoulGemConsumption(
+        const SoulGemConsumer consumer,
+        const SoulGemConsumption consumption) noexcept
+    {
+        soulGemConsumptions_[consumer][consumption].add();
+    }
+
+    /**
+     * @brief Records a shadow mode dry run along with the real soul trap it
+     * was compared against.
+     *
+     * The durations measure different work and are kept as separate series:
+     * productionPlacementDuration includes the real inventory scans and
+     * changes, while simulationDuration only covers the in-memory dry run.
+     */
+    void recordShadowRun(
+        TrapOutcome productionOutcome,
+        TrapOutcome shadowOutcome,
+        clock_type::duration productionPlacementDuration,
+        clock_type::duration simulationDuration) noexcept;
+
+    void recordShadowRunDropped() noexcept { shadowRunsDropped_.add(); }
+
+    /**
+     * @brief Returns all metrics in Prometheus text exposition format.
+     */
+    std::string toPrometheusText() const;
+};
@@ -0,0 +1,99 @@
+#include "MetricsExporter.hpp"
+
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include "Metrics.hpp"
+#include "../global.hpp"
+
+using namespace std::literals;
+
+void MetricsExporter::run_(
+    const std::stop_token stopToken,
+    MetricsExporter& exporter,
+    const std::filesystem::path path,
+    const std::chrono::seconds interval)
+{
+    std::unique_lock lock(exporter.mutex_);
+
+    while (true) {
+        // Only returns early if a stop is requested.
+        exporter.wakeUp_.wait_for(lock, stopToken, interval, [] {
+            return false;
+        });
+
+        if (stopToken.stop_requested()) {
+            break;
+        }
+
+        writeMetrics(path);
+    }
+}
+
+void MetricsExporter::start(
+    std::filesystem::path path,
+    const std::chrono::seconds interval)
+{
+    stop();
+
+    LOG_INFO_FMT(
+        "Writing metrics to \"{}\" every {} second(s)."sv,
+        path.string(),
+        interval.count());
+
+    thread_ = std::jthread(
+        &MetricsExporter::run_,
+        std::ref(*this),
+        std::move(path),
+        interval);
+}
+
+void MetricsExporter::stop()
+{
+    if (thread_.joinable()) {
+        thread_.request_stop();
+        thread_.join();
+    }
+}
+
+bool MetricsExporter::writeMetrics(const std::filesystem::path& path)
+{
+    auto tempPath = path;
+    tempPath += ".tmp"sv;
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file << Metrics::getInstance().toPrometheusText();
+        // Close before checking so errors from the final flush are caught too.
+        file.close();
+
+        if (!file) {
+            LOG_CHANNEL_WARN_LIMITED_FMT(
+                LogChannel::Metrics,
+                "Failed to write metrics to \"{}\".",
+                tempPath.string());
+
+            // Don't leave a truncated file behind.
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    // Replaces the existing file in one step so readers never see a partially
+    // written file.
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+
+    if (error) {
+        LOG_CHANNEL_WARN_LIMITED_FMT(
+            LogChannel::Metrics,
+            "Failed to replace metrics file \"{}\": {}",
+            path.string(),
+            error.message());
+        return false;
+    }
+
+    return true;
+}
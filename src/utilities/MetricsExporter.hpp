@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Periodically writes the contents of Metrics to a file in Prometheus
+ * text exposition format.
+ *
+ * The file is written from a background thread. It is first written to a
+ * temporary file which then replaces the output file, so readers never see a
+ * partially written file.
+ */
+class MetricsExporter {
+    std::jthread thread_;
+    std::mutex mutex_;
+    std::condition_variable_any wakeUp_;
+
+    explicit MetricsExporter() = default;
+
+    static void run_(
+        std::stop_token stopToken,
+        MetricsExporter& exporter,
+        std::filesystem::path path,
+        std::chrono::seconds interval);
+
+public:
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter(MetricsExporter&&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(MetricsExporter&&) = delete;
+
+    ~MetricsExporter() { stop(); }
+
+    static MetricsExporter& getInstance()
+    {
+        static MetricsExporter instance;
+        return instance;
+    }
+
+    /**
+     * @brief Starts writing metrics to path every interval. Restarts the
+     * exporter if it is already running.
+     */
+    void start(std::filesystem::path path, std::chrono::seconds interval);
+
+    /**
+     * @brief Stops the exporter. Does nothing if the exporter isn't running.
+     */
+    void stop();
+
+    /**
+     * @brief Writes the current metrics to path, replacing the file.
+     *
+     * @returns true if the file was written successfully, false otherwise.
+     */
+    static bool writeMetrics(const std::filesystem::path& path);
+};
@@ -2,17 +2,23 @@
 
 #include <functional>
 #include <sstream>
+#include <vector>
+
+#include <cstdint>
 
 #include <RE/M/Misc.h>
+#include <RE/T/TESSoulGem.h>
 #include <RE/V/VirtualMachine.h>
 
 #include "../global.hpp"
 #include "../messages.hpp"
 #include "../config/YASTMConfig.hpp"
 #include "../trapsoul/trapsoul.hpp"
+#include "../utilities/LogChannel.hpp"
 #include "../utilities/native.hpp"
 #include "../utilities/PapyrusFunctionRegistry.hpp"
 #include "../utilities/printerror.hpp"
+#include "../utilities/stringutils.hpp"
 #include "../utilities/Timer.hpp"
 
 using namespace std::literals;
@@ -64,6 +70,101 @@ namespace {
         return trapSoul(caster, victim) ? caster : nullptr;
     }
 
+    bool SetLogLevel(
+        VirtualMachine* const vm,
+        const RE::VMStackID stackId,
+        RE::StaticFunctionTag*,
+        const RE::BSFixedString channelName,
+        const RE::BSFixedString levelName)
+    {
+        const auto level = fromLogLevelString(levelName.c_str());
+
+        if (!level.has_value()) {
+            vm->TraceStack(
+                fmt::format(
+                    FMT_STRING("Invalid log level \"{}\""),
+                    levelName.c_str())
+                    .c_str(),
+                stackId);
+            return false;
+        }
+
+        auto& registry = LogChannelRegistry::getInstance();
+
+        // BSFixedString may return the string with a different case, since
+        // the game's string pool is case-insensitive.
+        if (getLowerString(channelName.c_str()) == "all"sv) {
+            registry.setLevel(*level);
+            LOG_INFO_FMT(
+                "Log level for all channels set to {}",
+                spdlog::level::to_string_view(*level));
+            return true;
+        }
+
+        const auto channel = fromLogChannelString(channelName.c_str());
+
+        if (!channel.has_value()) {
+            vm->TraceStack(
+                fmt::format(
+                    FMT_STRING("Invalid log channel \"{}\""),
+                    channelName.c_str())
+                    .c_str(),
+                stackId);
+            return false;
+        }
+
+        registry.setLevel(*channel, *level);
+        LOG_INFO_FMT(
+            "Log level for channel \"{}\" set to {}",
+            toString(*channel),
+            spdlog::level::to_string_view(*level));
+
+        return true;
+    }
+
+    RE::BSFixedString GetLogLevel(
+        VirtualMachine* const vm,
+        const RE::VMStackID stackId,
+        RE::StaticFunctionTag*,
+        const RE::BSFixedString channelName)
+    {
+        const auto channel = fromLogChannelString(channelName.c_str());
+
+        if (!channel.has_value()) {
+            vm->TraceStack(
+                fmt::format(
+                    FMT_STRING("Invalid log channel \"{}\""),
+                    channelName.c_str())
+                    .c_str(),
+                stackId);
+            return "";
+        }
+
+        const auto levelName = spdlog::level::to_string_view(
+            LogChannelRegistry::getInstance().level(*channel));
+
+        return RE::BSFixedString(
+            std::string_view(levelName.data(), levelName.size()));
+    }
+
+    std::vector<RE::BSFixedString> GetSoulGemGroupIds(RE::StaticFunctionTag*)
+    {
+        const auto table = YASTMConfig::getInstance().soulGemMap().groupTable();
+        return table->ids;
+    }
+
+    std::vector<std::int32_t> GetSoulGemGroupProperties(RE::StaticFunctionTag*)
+    {
+        const auto table = YASTMConfig::getInstance().soulGemMap().groupTable();
+        return table->properties;
+    }
+
+    std::vector<RE::TESSoulGem*> GetSoulGemGroupMembers(RE::StaticFunctionTag*)
+    {
+        const auto table = YASTMConfig::getInstance().soulGemMap().groupTable();
+        return table->members;
+    }
+
     bool registerPapyrusFunctions_(VirtualMachine* const vm)
     {
         if (vm == nullptr) {
@@ -74,6 +175,15 @@ namespace {
         PapyrusFunctionRegistry registry("YASTMUtils", vm);
 
         registry.registerFunction("TrapSoulAndGetCaster", TrapSoulAndGetCaster);
+        registry.registerFunction("SetLogLevel", SetLogLevel);
+        registry.registerFunction("GetLogLevel", GetLogLevel);
+        registry.registerFunction("GetSoulGemGroupIds", GetSoulGemGroupIds);
+        registry.registerFunction(
+            "GetSoulGemGroupProperties",
+            GetSoulGemGroupProperties);
+        registry.registerFunction(
+            "GetSoulGemGroupMembers",
+            GetSoulGemGroupMembers);
 
         return true;
     }
@@ -0,0 +1,393 @@
+// Host-side benchmark and stress test for the FSUtils ConfigManager.
+//
+// Drives several threads through open/create/get/set/save/close on a shared
+// set of handles and checks that:
+//
+// - every handle returned by openConfig()/createConfig() is unique,
+// - a closed handle never resolves to a config again,
+// - every set() on a shared config is visible once all threads are done.
+//
+// Throughput and tail latency are reported for a read-heavy and a write-heavy
+// mix at each thread count. Exits with a non-zero status if any check fails.
+// Build with the "tsan" preset to run it under ThreadSanitizer.
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "fsutils/internal/ConfigManager.hpp"
+
+using namespace std::literals;
+
+namespace {
+    using clock_type = std::chrono::steady_clock;
+    using HandleType = ConfigManager::HandleType;
+
+    constexpr std::size_t SHARED_HANDLE_COUNT_ = 64;
+    constexpr int SEED_KEY_COUNT_ = 50;
+
+    struct Mix {
+        std::string_view name;
+        /**
+         * @brief Percentage of operations that are set() calls. Open/close,
+         * save, stale handle lookups and size() calls take 1% each and the
+         * rest are get() calls.
+         */
+        int setPercent;
+    };
+
+    constexpr Mix MIXES_[] = {
+        {"read-heavy"sv, 5},
+        {"write-heavy"sv, 50},
+    };
+
+    struct Options {
+        std::vector<int> threadCounts = {1, 2, 4, 8};
+        int opsPerThread = 20000;
+    };
+
+    struct Write {
+        HandleType handle;
+        std::string key;
+        std::int64_t value;
+    };
+
+    struct ThreadResult {
+        std::vector<double> latencies;
+        std::vector<HandleType> issuedHandles;
+        std::vector<Write> writes;
+        std::size_t staleHits = 0;
+    };
+
+    struct RunResult {
+        double seconds;
+        std::size_t ops;
+        double p50;
+        double p99;
+        double p999;
+        double max;
+        std::size_t violations;
+    };
+
+    std::vector<int> parseThreadCounts_(const std::string_view str)
+    {
+        std::vector<int> result;
+        std::size_t begin = 0;
+
+        while (begin <= str.size()) {
+            const auto end = std::min(str.find(',', begin), str.size());
+            const auto count =
+                std::atoi(std::string(str.substr(begin, end - begin)).c_str());
+
+            if (count > 0) {
+                result.push_back(count);
+            }
+
+            begin = end + 1;
+        }
+
+        return result;
+    }
+
+    Options parseOptions_(const int argc, char* const argv[])
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg(argv[i]);
+
+            if (arg == "--quick"sv) {
+                options.threadCounts = {4};
+                options.opsPerThread = 2000;
+            } else if (arg == "--threads"sv && i + 1 < argc) {
+                options.threadCounts = parseThreadCounts_(argv[++i]);
+            } else if (arg == "--ops"sv && i + 1 < argc) {
+                options.opsPerThread = std::max(std::atoi(argv[++i]), 1);
+            } else {
+                std::fprintf(
+                    stderr,
+                    "Usage: %s [--quick] [--threads N[,N...]] [--ops N]\n",
+                    argv[0]);
+                std::exit(2);
+            }
+        }
+
+        return options;
+    }
+
+    double percentile_(const std::vector<double>& sorted, const double p)
+    {
+        const auto index = static_cast<std::size_t>(p * sorted.size());
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    void runThread_(
+        const int threadIndex,
+        const int ops,
+        const Mix& mix,
+        const std::vector<HandleType>& sharedHandles,
+        const std::filesystem::path& workDir,
+        std::barrier<>& startBarrier,
+        ThreadResult& result)
+    {
+        auto& manager = ConfigManager::getInstance();
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(
+            1234 + threadIndex));
+        std::vector<HandleType> closedHandles;
+        const auto seedPath = workDir / "seed.toml";
+        const auto savePath =
+            workDir / ("save" + std::to_string(threadIndex) + ".toml");
+
+        result.latencies.reserve(static_cast<std::size_t>(ops));
+
+        startBarrier.arrive_and_wait();
+
+        for (int i = 0; i < ops; ++i) {
+            const auto roll = static_cast<int>(rng() % 100);
+            const auto handle = sharedHandles[rng() % sharedHandles.size()];
+            const auto begin = clock_type::now();
+
+            if (roll == 0) {
+                // Open or create a private handle and close it again.
+                const auto ownHandle = (rng() % 2 == 0)
+                                           ? manager.openConfig(seedPath)
+                                           : manager.createConfig();
+
+                if (const auto config = manager.getConfig(ownHandle);
+                    config != nullptr) {
+                    config->set("owner"sv, std::int64_t{threadIndex});
+                }
+
+                manager.closeConfig(ownHandle);
+                result.issuedHandles.push_back(ownHandle);
+                closedHandles.push_back(ownHandle);
+            } else if (roll == 1) {
+                // A closed handle must never come back, even if the handle
+                // counter has moved on since. If it does, use the config like
+                // a script holding a stale handle would.
+                if (!closedHandles.empty()) {
+                    const auto config = manager.getConfig(
+                        closedHandles[rng() % closedHandles.size()]);
+
+                    if (config != nullptr) {
+                        ++result.staleHits;
+                        static_cast<void>(config->has("owner"sv));
+                    }
+                }
+            } else if (roll == 2) {
+                manager.saveConfig(handle, savePath);
+            } else if (roll == 3) {
+                static_cast<void>(manager.size());
+            } else if (roll < 4 + mix.setPercent) {
+                // Keys are unique per write so every write can be checked
+                // afterwards.
+                auto key = "t" + std::to_string(threadIndex) + "_" +
+                           std::to_string(i);
+
+                if (const auto config = manager.getConfig(handle);
+                    config != nullptr) {
+                    config->set(key, std::int64_t{i});
+                    result.writes.push_back({handle, std::move(key), i});
+                }
+            } else {
+                const auto key =
+                    "k" + std::to_string(rng() % SEED_KEY_COUNT_);
+
+                if (const auto config = manager.getConfig(handle);
+                    config != nullptr) {
+                    static_cast<void>(
+                        config->get<std::int64_t>(key, std::int64_t{0}));
+                }
+            }
+
+            result.latencies.push_back(
+                std::chrono::duration<double, std::micro>(
+                    clock_type::now() - begin)
+                    .count());
+        }
+    }
+
+    std::size_t checkResults_(
+        const std::vector<HandleType>& sharedHandles,
+        const std::vector<ThreadResult>& results)
+    {
+        auto& manager = ConfigManager::getInstance();
+        std::size_t violations = 0;
+        std::unordered_set<HandleType> seenHandles(
+            sharedHandles.begin(),
+            sharedHandles.end());
+
+        for (const auto& result : results) {
+            for (const auto handle : result.issuedHandles) {
+                if (!seenHandles.insert(handle).second) {
+                    std::fprintf(stderr, "Handle %d issued twice\n", handle);
+                    ++violations;
+                }
+            }
+
+            if (result.staleHits > 0) {
+                std::fprintf(
+                    stderr,
+                    "%zu lookup(s) of a closed handle returned a config\n",
+                    result.staleHits);
+                violations += result.staleHits;
+            }
+
+            for (const auto& write : result.writes) {
+                const auto config = manager.getConfig(write.handle);
+
+                if (config == nullptr ||
+                    config->get<std::int64_t>(write.key, -1) != write.value) {
+                    std::fprintf(
+                        stderr,
+                        "Lost update: handle %d key %s\n",
+                        write.handle,
+                        write.key.c_str());
+                    ++violations;
+                }
+            }
+        }
+
+        return violations;
+    }
+
+    RunResult runMix_(
+        const Mix& mix,
+        const int threadCount,
+        const int opsPerThread,
+        const std::filesystem::path& workDir)
+    {
+        auto& manager = ConfigManager::getInstance();
+        std::vector<HandleType> sharedHandles;
+
+        for (std::size_t i = 0; i < SHARED_HANDLE_COUNT_; ++i) {
+            sharedHandles.push_back(
+                (i % 2 == 0) ? manager.openConfig(workDir / "seed.toml")
+                             : manager.createConfig());
+        }
+
+        std::vector<ThreadResult> results(
+            static_cast<std::size_t>(threadCount));
+        std::barrier startBarrier(threadCount + 1);
+        std::vector<std::jthread> threads;
+
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back(
+                runThread_,
+                i,
+                opsPerThread,
+                std::cref(mix),
+                std::cref(sharedHandles),
+                std::cref(workDir),
+                std::ref(startBarrier),
+                std::ref(results[static_cast<std::size_t>(i)]));
+        }
+
+        startBarrier.arrive_and_wait();
+        const auto begin = clock_type::now();
+
+        for (auto& thread : threads) { thread.join(); }
+
+        const std::chrono::duration<double> elapsed =
+            clock_type::now() - begin;
+
+        std::vector<double> latencies;
+
+        for (const auto& result : results) {
+            latencies.insert(
+                latencies.end(),
+                result.latencies.begin(),
+                result.latencies.end());
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        const auto violations = checkResults_(sharedHandles, results);
+
+        manager.closeAllConfigs();
+
+        return {
+            elapsed.count(),
+            latencies.size(),
+            percentile_(latencies, 0.5),
+            percentile_(latencies, 0.99),
+            percentile_(latencies, 0.999),
+            latencies.back(),
+            violations};
+    }
+} // namespace
+
+int main(const int argc, char* argv[])
+{
+    const auto options = parseOptions_(argc, argv);
+    const auto workDir =
+        std::filesystem::temp_directory_path() / "yastm_fsutils_stress";
+
+    std::filesystem::create_directories(workDir);
+
+    {
+        std::ofstream seedFile(workDir / "seed.toml");
+
+        for (int i = 0; i < SEED_KEY_COUNT_; ++i) {
+            seedFile << "k" << i << " = " << i << "\n";
+        }
+    }
+
+    std::printf(
+        "hardware threads: %u, ops per thread: %d\n",
+        std::thread::hardware_concurrency(),
+        options.opsPerThread);
+    std::printf(
+        "%-12s %7s %12s %9s %9s %10s %10s %10s\n",
+        "mix",
+        "threads",
+        "ops/s",
+        "p50(us)",
+        "p99(us)",
+        "p99.9(us)",
+        "max(us)",
+        "violations");
+
+    std::size_t totalViolations = 0;
+
+    for (const auto& mix : MIXES_) {
+        for (const auto threadCount : options.threadCounts) {
+            const auto result = runMix_(
+                mix,
+                threadCount,
+                options.opsPerThread,
+                workDir);
+
+            std::printf(
+                "%-12.*s %7d %12.0f %9.1f %9.1f %10.1f %10.0f %10zu\n",
+                static_cast<int>(mix.name.size()),
+                mix.name.data(),
+                threadCount,
+                static_cast<double>(result.ops) / result.seconds,
+                result.p50,
+                result.p99,
+                result.p999,
+                result.max,
+                result.violations);
+
+            totalViolations += result.violations;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(workDir, error);
+
+    return totalViolations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Stand-in for the plugin's precompiled header (src/PCH.hpp), which the plugin
+// build force-includes into every translation unit.
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+
+namespace SKSE {
+    namespace log = spdlog;
+} // namespace SKSE
+
+using namespace std::literals;
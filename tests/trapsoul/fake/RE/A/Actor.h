@@ -0,0 +1,13 @@
+#pragma once
+
+// Stand-in for CommonLibSSE's RE::Actor. The soul trap logic only passes
+// actors through to the backend, apart from logging their names.
+
+namespace RE {
+    class Actor {
+    public:
+        virtual ~Actor() {}
+
+        virtual const char* GetName() const = 0;
+    };
+} // namespace RE
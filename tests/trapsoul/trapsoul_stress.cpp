@@ -0,0 +1,789 @@
+// Host-side benchmark and stress test for the soul trap.
+//
+// Drives several threads through trapSoul() against a fake backend that keeps
+// the soul gems of a few casters in memory. The fake backend has no locking of
+// its own, so it relies entirely on the soul trap lock. Victims are shared
+// between threads, so the same victim is often trapped by several threads at
+// once. Displaced souls are relocated by a separate "main thread" that runs
+// the backend's tasks, like the game's task queue. Checks that:
+//
+// - every victim's soul is trapped at most once,
+// - no soul gem fill is lost: replaying the fills on the initial inventories
+//   gives the final inventories, and no fill works on a stale inventory scan,
+// - souls are conserved: every soul displaced from a soul gem is either
+//   placed in another soul gem or counted as discarded in Metrics.
+//
+// Souls are never shrunk or split so they keep their size, which is what the
+// conservation check relies on. Throughput and latency are reported at each
+// thread count. Exits with a non-zero status if any check fails. Build with
+// the "tsan" preset to run it under ThreadSanitizer.
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <RE/A/Actor.h>
+
+#include "SoulSize.hpp"
+#include "config/ConfigSnapshot.hpp"
+#include "config/SoulTierTable.hpp"
+#include "trapsoul/SoulTrapBackend.hpp"
+#include "trapsoul/trapsoul.hpp"
+#include "utilities/EnumArray.hpp"
+#include "utilities/LogChannel.hpp"
+#include "utilities/Metrics.hpp"
+
+using namespace std::literals;
+
+namespace {
+    using clock_type = std::chrono::steady_clock;
+
+    /**
+     * @brief Number of soul gems owned, by capacity and contained soul size.
+     */
+    using SoulGemCounts =
+        EnumArray<SoulGemCapacity, EnumArray<SoulSize, std::int64_t>>;
+    using SoulCounts = EnumArray<SoulSize, std::int64_t>;
+
+    constexpr int CASTER_COUNT_ = 4;
+    /**
+     * @brief Average number of times each victim is trapped.
+     */
+    constexpr int TRAPS_PER_VICTIM_ = 4;
+
+    struct Options {
+        std::vector<int> threadCounts = {1, 2, 4, 8};
+        int opsPerThread = 20000;
+    };
+
+    struct Fill {
+        SoulGemCapacity capacity;
+        SoulSize containedSoulSize;
+        SoulSize soulSize;
+    };
+
+    struct RunResult {
+        double seconds;
+        std::size_t ops;
+        std::size_t trapped;
+        std::size_t discarded;
+        double p50;
+        double p99;
+        double max;
+        std::size_t violations;
+    };
+
+    bool isFull_(const SoulGemCapacity capacity, const SoulSize soulSize)
+    {
+        switch (capacity) {
+        case SoulGemCapacity::Dual:
+            return soulSize >= SoulSize::Grand;
+        case SoulGemCapacity::Black:
+            return soulSize == SoulSize::Black;
+        default:
+            return soulSize == toSoulSize(capacity);
+        }
+    }
+
+    /**
+     * @brief Returns the contained soul sizes of the soul gems with the given
+     * capacity. Dual soul gems can also hold a black soul.
+     */
+    std::vector<SoulSize> containedSoulSizes_(const SoulGemCapacity capacity)
+    {
+        const auto members = SoulTierTable::memberSoulSizes(capacity);
+        std::vector<SoulSize> result(members.begin(), members.end());
+
+        if (capacity == SoulGemCapacity::Dual) {
+            result.push_back(SoulSize::Black);
+        }
+
+        return result;
+    }
+
+    bool isValidSoulGem_(
+        const SoulGemCapacity capacity,
+        const SoulSize containedSoulSize)
+    {
+        const auto soulSizes = containedSoulSizes_(capacity);
+
+        return std::find(
+                   soulSizes.begin(),
+                   soulSizes.end(),
+                   containedSoulSize) != soulSizes.end();
+    }
+
+    void forEachSoulGem_(
+        const std::function<void(SoulGemCapacity, SoulSize)>& fn)
+    {
+        forEachSoulGemCapacity([&](const SoulGemCapacity capacity) {
+            for (const auto soulSize : containedSoulSizes_(capacity)) {
+                fn(capacity, soulSize);
+            }
+        });
+    }
+
+    class FakeActor_ : public RE::Actor {
+        std::string name_;
+
+    public:
+        SoulTrapBackend::FormID formId = 0;
+        bool isDead = false;
+        SoulSize soulSize = SoulSize::None;
+
+        // Victim state. isSoulTrapped is only accessed by the backend, i.e.
+        // with the soul trap lock held.
+        bool isSoulTrapped = false;
+        std::atomic<int> trapCount = 0;
+
+        // Caster state, only accessed by the backend.
+        SoulGemCounts soulGems{};
+        std::vector<Fill> fills;
+
+        explicit FakeActor_(std::string name)
+            : name_(std::move(name))
+        {}
+
+        const char* GetName() const override { return name_.c_str(); }
+    };
+
+    FakeActor_& fake_(RE::Actor* const actor)
+    {
+        return *static_cast<FakeActor_*>(actor);
+    }
+
+    class FakeBackend_;
+
+    /**
+     * @brief Works on a scan of the caster's soul gems like the game backend,
+     * so a fill based on a scan taken before another thread changed the
+     * inventory is caught.
+     */
+    class FakeInventory_ : public SoulTrapBackend::Inventory {
+        FakeActor_& caster_;
+        FakeBackend_& backend_;
+        SoulGemCounts scan_{};
+        bool isScanDirty_ = true;
+
+        void refresh_()
+        {
+            if (isScanDirty_) {
+                scan_ = caster_.soulGems;
+                isScanDirty_ = false;
+            }
+        }
+
+    public:
+        explicit FakeInventory_(FakeActor_& caster, FakeBackend_& backend)
+            : caster_(caster)
+            , backend_(backend)
+        {}
+
+        InventoryStatus status() override;
+
+        bool hasSoulGem(
+            const SoulGemCapacity capacity,
+            const SoulSize containedSoulSize) override
+        {
+            refresh_();
+            return scan_[capacity][containedSoulSize] > 0;
+        }
+
+        std::optional<SoulSize> fillSoulGem(
+            SoulGemCapacity capacity,
+            SoulSize containedSoulSize,
+            SoulSize soulSize) override;
+
+        ShadowTrapRunner::InventorySnapshot countSoulGems() override
+        {
+            return {};
+        }
+    };
+
+    class FakeBackend_ : public SoulTrapBackend {
+        std::unordered_map<FormID, FakeActor_*> actors_;
+        ConfigSnapshot::BoolValues configBools_;
+
+        std::mutex tasksMutex_;
+        std::condition_variable_any tasksChanged_;
+        std::deque<std::function<void()>> tasks_;
+
+    public:
+        std::atomic<std::size_t> fillCount = 0;
+        std::atomic<std::size_t> violations = 0;
+
+        explicit FakeBackend_(const std::vector<FakeActor_*>& actors)
+        {
+            for (const auto actor : actors) {
+                actors_.emplace(actor->formId, actor);
+            }
+
+            using BC = BoolConfigKey;
+
+            configBools_[static_cast<std::size_t>(
+                BC::AllowPartiallyFillingSoulGems)] = true;
+            configBools_[static_cast<std::size_t>(BC::AllowSoulDisplacement)] =
+                true;
+            configBools_[static_cast<std::size_t>(BC::AllowSoulRelocation)] =
+                true;
+        }
+
+        bool isDead(RE::Actor* const actor) override
+        {
+            return fake_(actor).isDead;
+        }
+
+        bool isPlayer(RE::Actor*) override { return false; }
+
+        FormID getFormId(RE::Actor* const actor) override
+        {
+            return fake_(actor).formId;
+        }
+
+        RE::Actor* lookupActor(const FormID formId) override
+        {
+            const auto it = actors_.find(formId);
+            return it != actors_.end() ? it->second : nullptr;
+        }
+
+        int getSoulTrapLevel(RE::Actor*) override { return 100; }
+
+        std::unique_ptr<Inventory> getInventory(
+            RE::Actor* const caster,
+            const ConfigSnapshot&) override
+        {
+            return std::make_unique<FakeInventory_>(fake_(caster), *this);
+        }
+
+        SoulSize getSoulSize(RE::Actor* const victim) override
+        {
+            return fake_(victim).soulSize;
+        }
+
+        bool isSoulTrapped(RE::Actor* const victim) override
+        {
+            return fake_(victim).isSoulTrapped;
+        }
+
+        void flagSoulTrapped(RE::Actor* const victim) override
+        {
+            fake_(victim).isSoulTrapped = true;
+        }
+
+        ConfigSnapshot snapshotConfig(int) override
+        {
+            return ConfigSnapshot(
+                configBools_,
+                {
+                    {EnumConfigKey::SoulShrinkingTechnique,
+                     static_cast<EnumConfigUnderlyingType>(
+                         SoulShrinkingTechnique::None)},
+                    {EnumConfigKey::SoulTrapLevelingType,
+                     static_cast<EnumConfigUnderlyingType>(
+                         SoulTrapLevelingType::None)},
+                },
+                {});
+        }
+
+        const SoulTierTable& soulTiers() override
+        {
+            return SoulTierTable::vanilla();
+        }
+
+        void notify(const char*) override {}
+        void sendSoulTrapEvent(RE::Actor*, RE::Actor*) override {}
+
+        void addTask(std::function<void()> task) override
+        {
+            {
+                std::lock_guard guard(tasksMutex_);
+                tasks_.push_back(std::move(task));
+            }
+
+            tasksChanged_.notify_one();
+        }
+
+        std::optional<ShadowTrapRunner::ResolvedStrategy>
+            sampleShadowRun(const ConfigSnapshot&) override
+        {
+            return std::nullopt;
+        }
+
+        void submitShadowRun(ShadowTrapRunner::Run&&) override {}
+
+        /**
+         * @brief Runs queued tasks until stop is requested, then runs the
+         * tasks left in the queue.
+         */
+        void runTasks(const std::stop_token stopToken)
+        {
+            std::unique_lock lock(tasksMutex_);
+
+            while (true) {
+                tasksChanged_.wait(lock, stopToken, [this]() {
+                    return !tasks_.empty();
+                });
+
+                if (tasks_.empty()) {
+                    return;
+                }
+
+                auto task = std::move(tasks_.front());
+                tasks_.pop_front();
+
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+
+        void runRemainingTasks()
+        {
+            std::stop_source stopped;
+            stopped.request_stop();
+            runTasks(stopped.get_token());
+        }
+    };
+
+    InventoryStatus FakeInventory_::status()
+    {
+        refresh_();
+
+        bool hasSoulGems = false;
+        bool hasSoulGemsToFill = false;
+
+        forEachSoulGem_([&](const SoulGemCapacity capacity, const SoulSize s) {
+            if (scan_[capacity][s] > 0) {
+                hasSoulGems = true;
+                hasSoulGemsToFill = hasSoulGemsToFill || !isFull_(capacity, s);
+            }
+        });
+
+        if (!hasSoulGems) {
+            return InventoryStatus::NoSoulGemsOwned;
+        }
+
+        return hasSoulGemsToFill ? InventoryStatus::HasSoulGemsToFill
+                                 : InventoryStatus::AllSoulGemsFilled;
+    }
+
+    std::optional<SoulSize> FakeInventory_::fillSoulGem(
+        const SoulGemCapacity capacity,
+        const SoulSize containedSoulSize,
+        const SoulSize soulSize)
+    {
+        refresh_();
+
+        if (scan_[capacity][containedSoulSize] <= 0) {
+            return std::nullopt;
+        }
+
+        auto& count = caster_.soulGems[capacity][containedSoulSize];
+
+        if (count <= 0 || !isValidSoulGem_(capacity, soulSize)) {
+            std::fprintf(
+                stderr,
+                "%s: invalid fill (%s, %s) -> %s with %lld owned\n",
+                caster_.GetName(),
+                toString(capacity),
+                toString(containedSoulSize),
+                toString(soulSize),
+                static_cast<long long>(count));
+            ++backend_.violations;
+            return std::nullopt;
+        }
+
+        --count;
+        ++caster_.soulGems[capacity][soulSize];
+        caster_.fills.push_back({capacity, containedSoulSize, soulSize});
+        ++backend_.fillCount;
+        isScanDirty_ = true;
+
+        return SoulSize::None;
+    }
+
+    std::vector<int> parseThreadCounts_(const std::string_view str)
+    {
+        std::vector<int> result;
+        std::size_t begin = 0;
+
+        while (begin <= str.size()) {
+            const auto end = std::min(str.find(',', begin), str.size());
+            const auto count =
+                std::atoi(std::string(str.substr(begin, end - begin)).c_str());
+
+            if (count > 0) {
+                result.push_back(count);
+            }
+
+            begin = end + 1;
+        }
+
+        return result;
+    }
+
+    Options parseOptions_(const int argc, char* const argv[])
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg(argv[i]);
+
+            if (arg == "--quick"sv) {
+                options.threadCounts = {4};
+                options.opsPerThread = 2000;
+            } else if (arg == "--threads"sv && i + 1 < argc) {
+                options.threadCounts = parseThreadCounts_(argv[++i]);
+            } else if (arg == "--ops"sv && i + 1 < argc) {
+                options.opsPerThread = std::max(std::atoi(argv[++i]), 1);
+            } else {
+                std::fprintf(
+                    stderr,
+                    "Usage: %s [--quick] [--threads N[,N...]] [--ops N]\n",
+                    argv[0]);
+                std::exit(2);
+            }
+        }
+
+        return options;
+    }
+
+    double percentile_(const std::vector<double>& sorted, const double p)
+    {
+        const auto index = static_cast<std::size_t>(p * sorted.size());
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    /**
+     * @brief Reads the discarded soul counters from the Prometheus output,
+     * since Metrics has no other way to read them.
+     */
+    SoulCounts readDiscardedSouls_()
+    {
+        const auto text = Metrics::getInstance().toPrometheusText();
+        SoulCounts result{};
+
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            const auto soulSize = static_cast<SoulSize>(i);
+            const auto prefix = fmt::format(
+                "yastm_discarded_souls_total{{soul_size=\"{}\"}} ",
+                toString(soulSize));
+
+            if (const auto pos = text.find(prefix); pos != std::string::npos) {
+                result[soulSize] =
+                    std::atoll(text.c_str() + pos + prefix.size());
+            }
+        }
+
+        return result;
+    }
+
+    void runThread_(
+        const int threadIndex,
+        const int ops,
+        const std::vector<FakeActor_*>& casters,
+        const std::vector<FakeActor_*>& victims,
+        FakeBackend_& backend,
+        std::barrier<>& startBarrier,
+        std::vector<double>& latencies)
+    {
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(
+            1234 + threadIndex));
+
+        latencies.reserve(static_cast<std::size_t>(ops));
+
+        startBarrier.arrive_and_wait();
+
+        for (int i = 0; i < ops; ++i) {
+            const auto caster = casters[rng() % casters.size()];
+            const auto victim = victims[rng() % victims.size()];
+            const auto begin = clock_type::now();
+
+            if (trapSoul(caster, victim, backend)) {
+                ++victim->trapCount;
+            }
+
+            latencies.push_back(
+                std::chrono::duration<double, std::micro>(
+                    clock_type::now() - begin)
+                    .count());
+        }
+    }
+
+    std::size_t checkResults_(
+        const std::vector<std::unique_ptr<FakeActor_>>& casters,
+        const std::vector<SoulGemCounts>& initialSoulGems,
+        const std::vector<std::unique_ptr<FakeActor_>>& victims,
+        const SoulCounts& discarded,
+        const FakeBackend_& backend)
+    {
+        std::size_t violations = backend.violations.load();
+        std::size_t fillCount = 0;
+        SoulCounts balance{};
+
+        // Every soul placed in a soul gem must be a trapped victim's soul or a
+        // soul displaced from another soul gem, and every displaced soul must
+        // be placed again or discarded.
+        for (const auto& victim : victims) {
+            const auto trapCount = victim->trapCount.load();
+
+            if (trapCount > 1 ||
+                (trapCount == 1) != victim->isSoulTrapped) {
+                std::fprintf(
+                    stderr,
+                    "%s: trapped %d time(s), flagged: %d\n",
+                    victim->GetName(),
+                    trapCount,
+                    victim->isSoulTrapped);
+                ++violations;
+            }
+
+            balance[victim->soulSize] -= trapCount;
+        }
+
+        for (std::size_t i = 0; i < casters.size(); ++i) {
+            const auto& caster = *casters[i];
+            auto replayed = initialSoulGems[i];
+
+            for (const auto& fill : caster.fills) {
+                --replayed[fill.capacity][fill.containedSoulSize];
+                ++replayed[fill.capacity][fill.soulSize];
+
+                ++balance[fill.soulSize];
+                --balance[fill.containedSoulSize];
+            }
+
+            fillCount += caster.fills.size();
+
+            if (replayed != caster.soulGems) {
+                std::fprintf(
+                    stderr,
+                    "%s: soul gems don't match the recorded fills\n",
+                    caster.GetName());
+                ++violations;
+            }
+        }
+
+        if (fillCount != backend.fillCount.load()) {
+            std::fprintf(
+                stderr,
+                "%zu fill(s) recorded, %zu made\n",
+                fillCount,
+                backend.fillCount.load());
+            ++violations;
+        }
+
+        for (std::size_t i = 1; i < balance.size(); ++i) {
+            const auto soulSize = static_cast<SoulSize>(i);
+
+            if (balance[soulSize] + discarded[soulSize] != 0) {
+                std::fprintf(
+                    stderr,
+                    "%s souls: %lld placed without a source\n",
+                    toString(soulSize),
+                    static_cast<long long>(
+                        balance[soulSize] + discarded[soulSize]));
+                ++violations;
+            }
+        }
+
+        return violations;
+    }
+
+    RunResult runTraps_(const int threadCount, const int opsPerThread)
+    {
+        std::mt19937 rng(42);
+        std::vector<std::unique_ptr<FakeActor_>> casters;
+        std::vector<std::unique_ptr<FakeActor_>> victims;
+        std::vector<FakeActor_*> allActors;
+        std::vector<SoulGemCounts> initialSoulGems;
+
+        const auto victimCount = std::max<std::size_t>(
+            static_cast<std::size_t>(threadCount) * opsPerThread /
+                TRAPS_PER_VICTIM_,
+            1);
+        std::size_t soulGemKinds = 0;
+
+        forEachSoulGem_([&](SoulGemCapacity, SoulSize) { ++soulGemKinds; });
+
+        // Roughly one soul gem per victim, so casters run out of soul gems to
+        // fill some of the time.
+        const auto maxSoulGems = static_cast<int>(std::max<std::size_t>(
+            2 * victimCount / (CASTER_COUNT_ * soulGemKinds),
+            1));
+
+        for (int i = 0; i < CASTER_COUNT_; ++i) {
+            auto caster =
+                std::make_unique<FakeActor_>("caster" + std::to_string(i));
+            caster->formId = static_cast<SoulTrapBackend::FormID>(0x100 + i);
+
+            forEachSoulGem_([&](const SoulGemCapacity capacity,
+                                const SoulSize containedSoulSize) {
+                caster->soulGems[capacity][containedSoulSize] =
+                    static_cast<int>(rng() % (maxSoulGems + 1));
+            });
+
+            initialSoulGems.push_back(caster->soulGems);
+            allActors.push_back(caster.get());
+            casters.push_back(std::move(caster));
+        }
+
+        for (std::size_t i = 0; i < victimCount; ++i) {
+            auto victim =
+                std::make_unique<FakeActor_>("victim" + std::to_string(i));
+            victim->formId = static_cast<SoulTrapBackend::FormID>(0x10000 + i);
+            victim->isDead = true;
+            victim->soulSize = rng() % 8 == 0
+                                   ? SoulSize::Black
+                                   : static_cast<SoulSize>(1 + rng() % 5);
+
+            allActors.push_back(victim.get());
+            victims.push_back(std::move(victim));
+        }
+
+        FakeBackend_ backend(allActors);
+        const std::vector<FakeActor_*> casterPtrs(
+            allActors.begin(),
+            allActors.begin() + CASTER_COUNT_);
+        const std::vector<FakeActor_*> victimPtrs(
+            allActors.begin() + CASTER_COUNT_,
+            allActors.end());
+
+        const auto discardedBefore = readDiscardedSouls_();
+
+        std::vector<std::vector<double>> latencies(
+            static_cast<std::size_t>(threadCount));
+        std::barrier startBarrier(threadCount + 1);
+        std::vector<std::jthread> threads;
+        std::jthread taskThread([&backend](const std::stop_token stopToken) {
+            backend.runTasks(stopToken);
+        });
+
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back(
+                runThread_,
+                i,
+                opsPerThread,
+                std::cref(casterPtrs),
+                std::cref(victimPtrs),
+                std::ref(backend),
+                std::ref(startBarrier),
+                std::ref(latencies[static_cast<std::size_t>(i)]));
+        }
+
+        startBarrier.arrive_and_wait();
+        const auto begin = clock_type::now();
+
+        for (auto& thread : threads) { thread.join(); }
+
+        const std::chrono::duration<double> elapsed =
+            clock_type::now() - begin;
+
+        taskThread.request_stop();
+        taskThread.join();
+        backend.runRemainingTasks();
+
+        auto discarded = readDiscardedSouls_();
+        std::int64_t discardedTotal = 0;
+
+        for (std::size_t i = 0; i < discarded.size(); ++i) {
+            const auto soulSize = static_cast<SoulSize>(i);
+
+            discarded[soulSize] -= discardedBefore[soulSize];
+            discardedTotal += discarded[soulSize];
+        }
+
+        std::vector<double> allLatencies;
+        std::size_t trapped = 0;
+
+        for (const auto& threadLatencies : latencies) {
+            allLatencies.insert(
+                allLatencies.end(),
+                threadLatencies.begin(),
+                threadLatencies.end());
+        }
+
+        std::sort(allLatencies.begin(), allLatencies.end());
+
+        for (const auto& victim : victims) {
+            trapped += static_cast<std::size_t>(victim->trapCount.load());
+        }
+
+        return {
+            elapsed.count(),
+            allLatencies.size(),
+            trapped,
+            static_cast<std::size_t>(discardedTotal),
+            percentile_(allLatencies, 0.5),
+            percentile_(allLatencies, 0.99),
+            allLatencies.back(),
+            checkResults_(
+                casters,
+                initialSoulGems,
+                victims,
+                discarded,
+                backend)};
+    }
+} // namespace
+
+int main(const int argc, char* argv[])
+{
+    const auto options = parseOptions_(argc, argv);
+
+    // Trace logging would dominate the timings.
+    LogChannelRegistry::getInstance().setLevel(spdlog::level::info);
+
+    std::printf(
+        "hardware threads: %u, ops per thread: %d\n",
+        std::thread::hardware_concurrency(),
+        options.opsPerThread);
+    std::printf(
+        "%7s %12s %9s %9s %10s %8s %10s %10s\n",
+        "threads",
+        "ops/s",
+        "p50(us)",
+        "p99(us)",
+        "max(us)",
+        "trapped",
+        "discarded",
+        "violations");
+
+    std::size_t totalViolations = 0;
+
+    for (const auto threadCount : options.threadCounts) {
+        const auto result = runTraps_(threadCount, options.opsPerThread);
+
+        std::printf(
+            "%7d %12.0f %9.1f %9.1f %10.0f %8zu %10zu %10zu\n",
+            threadCount,
+            static_cast<double>(result.ops) / result.seconds,
+            result.p50,
+            result.p99,
+            result.max,
+            result.trapped,
+            result.discarded,
+            result.violations);
+
+        totalViolations += result.violations;
+    }
+
+    return totalViolations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}